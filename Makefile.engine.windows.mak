@@ -7,7 +7,7 @@ EXTENSION := .dll
 
 COMPILER_FLAGS := -g -MD -Werror=vla -fdeclspec
 INCLUDE_FLAGS := -Iengine\src -I$(VULKAN_SDK)\include
-LD_FLAGS := -g -shared -luser32 -lvulkan-1 -L$(VULKAN_SDK)\Lib -L$(OBJ_DIR)\engine
+LD_FLAGS := -g -shared -luser32 -lwinmm -lvulkan-1 -L$(VULKAN_SDK)\Lib -L$(OBJ_DIR)\engine
 DEFINES := -D_DEBUG -DRCEXPORT -D_CRT_SECURE_NO_WARNINGS
 
 rwildcard=$(wildcard $1$2) $(foreach d,$(wildcard $1*),$(call rwildcard,$d/,$2))
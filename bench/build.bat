@@ -0,0 +1,16 @@
+REM Build bench
+@ECHO OFF
+SetLocal EnabledDelayedExpansion
+
+REM Get the list of .c files
+SET cFilenames=
+FOR /R %%f in (*.c) do (SET cFilenames=!cFilenames! %%f)
+
+SET assembly=bench
+SET compilerFlags=-g -O2 -Wno-missing-braces
+SET includeFlags=-Isrc -I../engine/src/
+SET linkerFlags=-L../bin/ -lengine.lib
+SET defines=-D_DEBUG -DRCIMPORT
+
+ECHO "Building %assembly%..."
+clang %cFilenames% %compilerFlags% -o ../bin/%assembly%.exe %defines% %includeFlags% %linkerFlags%
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "bench.h"
+
+#include <containers/darray.h>
+#include <core/logger.h>
+#include <core/rcmemory.h>
+#include <core/rcstring.h>
+#include <core/string_builder.h>
+#include <platform/filesystem.h>
+#include <platform/platform.h>
+
+#if !defined(__clang__) && !defined(__GNUC__)
+const void *volatile bench_sink;
+#endif
+
+// Calibration stops growing the iteration count here, however fast the operation.
+#define BENCH_MAX_ITERATIONS (1ull << 30)
+#define BENCH_JSON_TEXT_SIZE 1024
+
+void bench_runner_create(const bench_options *options, bench_runner *out_runner)
+{
+    rczero_memory(out_runner, sizeof(bench_runner));
+    if (options)
+    {
+        out_runner->options = *options;
+    }
+    if (out_runner->options.samples == 0)
+    {
+        out_runner->options.samples = BENCH_DEFAULT_SAMPLES;
+    }
+    if (out_runner->options.min_sample_ns == 0)
+    {
+        out_runner->options.min_sample_ns = BENCH_DEFAULT_MIN_SAMPLE_NS;
+    }
+    out_runner->results = darray_create(bench_result);
+    out_runner->sample_ns = rcallocate(sizeof(f64) * out_runner->options.samples, MEMORY_TAG_ARRAY);
+}
+
+void bench_runner_destroy(bench_runner *runner)
+{
+    if (runner->results)
+    {
+        darray_destroy(runner->results);
+        runner->results = 0;
+    }
+    if (runner->sample_ns)
+    {
+        rcfree(runner->sample_ns, sizeof(f64) * runner->options.samples, MEMORY_TAG_ARRAY);
+        runner->sample_ns = 0;
+    }
+}
+
+static void sort_f64(f64 *values, u32 count)
+{
+    // Insertion sort; sample counts are small.
+    for (u32 i = 1; i < count; ++i)
+    {
+        f64 value = values[i];
+        u32 j = i;
+        for (; j > 0 && values[j - 1] > value; --j)
+        {
+            values[j] = values[j - 1];
+        }
+        values[j] = value;
+    }
+}
+
+// Median of sorted values.
+static f64 median(const f64 *sorted, u32 count)
+{
+    return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) * 0.5;
+}
+
+// Nearest-rank percentile of sorted values.
+static f64 percentile(const f64 *sorted, u32 count, u32 percent)
+{
+    u32 rank = (u32)(((u64)count * percent + 99) / 100);
+    return sorted[rank ? rank - 1 : 0];
+}
+
+// Times one sample, in nanoseconds for all its iterations. Returns false if the setup declined.
+static b8 run_sample(PFN_bench_setup setup, PFN_bench_run run, PFN_bench_teardown teardown, void *state, u64 iterations, u64 *out_ns)
+{
+    if (setup && !setup(state, iterations))
+    {
+        return false;
+    }
+
+    bench_clobber();
+    u64 start = platform_get_time_ns();
+    run(state, iterations);
+    bench_clobber();
+    *out_ns = platform_get_time_ns() - start;
+
+    if (teardown)
+    {
+        teardown(state);
+    }
+    return true;
+}
+
+void bench_run(bench_runner *runner, const char *name, PFN_bench_setup setup, PFN_bench_run run, PFN_bench_teardown teardown, void *state)
+{
+    const bench_options *options = &runner->options;
+    if (options->filter && string_find(name, options->filter) < 0)
+    {
+        return;
+    }
+
+    // Grow the iteration count until a sample is long enough, then round up to the target.
+    u64 iterations = 1;
+    u64 elapsed = 0;
+    for (;;)
+    {
+        if (!run_sample(setup, run, teardown, state, iterations, &elapsed))
+        {
+            RCWARN("%s: setup failed, skipping.", name);
+            return;
+        }
+        if (elapsed >= options->min_sample_ns || iterations >= BENCH_MAX_ITERATIONS)
+        {
+            break;
+        }
+        if (elapsed * 10 < options->min_sample_ns)
+        {
+            iterations *= 10;
+        }
+        else
+        {
+            u64 scaled = (u64)((f64)iterations * (f64)options->min_sample_ns * 1.2 / (f64)elapsed);
+            iterations = scaled > iterations ? scaled : iterations * 2;
+        }
+    }
+
+    for (u32 i = 0; i < options->warmup_samples; ++i)
+    {
+        run_sample(setup, run, teardown, state, iterations, &elapsed);
+    }
+
+    u32 count = options->samples;
+    f64 *samples = runner->sample_ns;
+    f64 total = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (!run_sample(setup, run, teardown, state, iterations, &elapsed))
+        {
+            RCWARN("%s: setup failed, skipping.", name);
+            return;
+        }
+        samples[i] = (f64)elapsed / (f64)iterations;
+        total += samples[i];
+    }
+
+    bench_result result;
+    rczero_memory(&result, sizeof(bench_result));
+    string_format(result.name, sizeof(result.name), "%s", name);
+    result.iterations = iterations;
+    result.sample_count = count;
+    result.mean_ns = total / (f64)count;
+
+    sort_f64(samples, count);
+    result.min_ns = samples[0];
+    result.max_ns = samples[count - 1];
+    result.median_ns = median(samples, count);
+    result.p5_ns = percentile(samples, count, 5);
+    result.p95_ns = percentile(samples, count, 95);
+    result.p99_ns = percentile(samples, count, 99);
+
+    // The deviations from the median, sorted in place, give the MAD.
+    for (u32 i = 0; i < count; ++i)
+    {
+        f64 deviation = samples[i] - result.median_ns;
+        samples[i] = deviation < 0 ? -deviation : deviation;
+    }
+    sort_f64(samples, count);
+    result.mad_ns = median(samples, count);
+
+    RCINFO(
+        "%-40s %10.2f ns  +/- %8.2f  p5 %10.2f  p95 %10.2f  p99 %10.2f  (%llu x %u)",
+        result.name,
+        result.median_ns,
+        result.mad_ns,
+        result.p5_ns,
+        result.p95_ns,
+        result.p99_ns,
+        result.iterations,
+        result.sample_count);
+
+    darray_push(runner->results, result);
+}
+
+static b8 write_text(file_handle *file, string_builder *builder)
+{
+    u64 written = 0;
+    b8 result = filesystem_write(file, builder->length, builder->buffer, &written);
+    string_builder_clear(builder);
+    return result && !builder->truncated;
+}
+
+b8 bench_write_json(bench_runner *runner, const char *path)
+{
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_WRITE, false, &file))
+    {
+        RCERROR("bench_write_json - could not open '%s' for writing.", path);
+        return false;
+    }
+
+    char text[BENCH_JSON_TEXT_SIZE];
+    string_builder builder;
+    string_builder_create(sizeof(text), text, &builder);
+
+    const bench_options *options = &runner->options;
+    string_builder_appendf(
+        &builder,
+        "{\"warmup_samples\":%u,\"samples\":%u,\"min_sample_ns\":%llu,\"benchmarks\":[",
+        options->warmup_samples,
+        options->samples,
+        options->min_sample_ns);
+    b8 ok = write_text(&file, &builder);
+
+    u64 count = darray_length(runner->results);
+    for (u64 i = 0; i < count && ok; ++i)
+    {
+        // Names are plain identifiers, so they need no escaping.
+        const bench_result *result = &runner->results[i];
+        string_builder_appendf(
+            &builder,
+            "%s\n{\"name\":\"%s\",\"iterations\":%llu,\"samples\":%u,\"median_ns\":%.3f,\"mad_ns\":%.3f,\"mean_ns\":%.3f,"
+            "\"min_ns\":%.3f,\"p5_ns\":%.3f,\"p95_ns\":%.3f,\"p99_ns\":%.3f,\"max_ns\":%.3f}",
+            i ? "," : "",
+            result->name,
+            result->iterations,
+            result->sample_count,
+            result->median_ns,
+            result->mad_ns,
+            result->mean_ns,
+            result->min_ns,
+            result->p5_ns,
+            result->p95_ns,
+            result->p99_ns,
+            result->max_ns);
+        ok = write_text(&file, &builder);
+    }
+
+    string_builder_append(&builder, "\n]}\n");
+    ok = ok && write_text(&file, &builder);
+    filesystem_close(&file);
+
+    if (!ok)
+    {
+        RCERROR("bench_write_json - failed writing '%s'.", path);
+        return false;
+    }
+    RCINFO("Wrote %llu results to '%s'.", count, path);
+    return true;
+}
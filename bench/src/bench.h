@@ -0,0 +1,127 @@
+#pragma once
+
+#include <defines.h>
+
+/**
+ * A small micro-benchmark harness. Each benchmark is a function that runs the
+ * operation under test a given number of times. The harness picks an
+ * iteration count that makes one sample long enough to time reliably, runs a
+ * few warm-up samples, then times a fixed number of samples and reports the
+ * time per operation as median, median absolute deviation and percentiles.
+ */
+
+/**
+ * Prepares the state for a sample of the given number of iterations. Not timed.
+ * @returns false to skip the benchmark.
+ */
+typedef b8 (*PFN_bench_setup)(void *state, u64 iterations);
+
+/** Runs the operation under test the given number of times. */
+typedef void (*PFN_bench_run)(void *state, u64 iterations);
+
+/** Releases whatever the setup made for a sample. Not timed. */
+typedef void (*PFN_bench_teardown)(void *state);
+
+typedef struct bench_result
+{
+    char name[64];
+    // Operations per sample.
+    u64 iterations;
+    u32 sample_count;
+    // Per-operation times in nanoseconds.
+    f64 median_ns;
+    f64 mad_ns;
+    f64 mean_ns;
+    f64 min_ns;
+    f64 p5_ns;
+    f64 p95_ns;
+    f64 p99_ns;
+    f64 max_ns;
+} bench_result;
+
+typedef struct bench_options
+{
+    u32 warmup_samples;
+    u32 samples;
+    // Iterations are scaled until one sample takes at least this long.
+    u64 min_sample_ns;
+    // Only benchmarks whose name contains this run. 0 runs everything.
+    const char *filter;
+} bench_options;
+
+typedef struct bench_runner
+{
+    bench_options options;
+    // darray of bench_result.
+    bench_result *results;
+    // Scratch for the per-operation time of each sample.
+    f64 *sample_ns;
+} bench_runner;
+
+#define BENCH_DEFAULT_WARMUP_SAMPLES 5
+#define BENCH_DEFAULT_SAMPLES 50
+#define BENCH_DEFAULT_MIN_SAMPLE_NS 500000ull
+
+/**
+ * Keeps the compiler from optimizing away the value at the given address: it
+ * must assume the value is read, and may have been changed, at this point.
+ * Use it on a benchmark's inputs so they are not constant-folded, and on its
+ * results so the work producing them is not dropped.
+ */
+#if defined(__clang__) || defined(__GNUC__)
+RCINLINE void bench_do_not_optimize(const void *value)
+{
+    __asm__ volatile("" : : "r"(value) : "memory");
+}
+
+/** Forces every pending write to memory to happen before this point. */
+RCINLINE void bench_clobber()
+{
+    __asm__ volatile("" : : : "memory");
+}
+#else
+extern const void *volatile bench_sink;
+
+RCINLINE void bench_do_not_optimize(const void *value)
+{
+    bench_sink = value;
+}
+
+RCINLINE void bench_clobber()
+{
+    bench_sink = 0;
+}
+#endif
+
+#define BENCH_DO_NOT_OPTIMIZE(value) bench_do_not_optimize(&(value))
+
+/**
+ * Creates a runner.
+ * @param options The options to run with. Zeroed fields take their defaults.
+ * @param out_runner A pointer to hold the runner.
+ */
+void bench_runner_create(const bench_options *options, bench_runner *out_runner);
+
+/**
+ * Destroys a runner and its results.
+ */
+void bench_runner_destroy(bench_runner *runner);
+
+/**
+ * Times a benchmark, unless the filter excludes it, and logs its result.
+ * @param runner The runner.
+ * @param name The benchmark's name; by convention "suite/case".
+ * @param setup Called before each sample. Optional.
+ * @param run The operation under test.
+ * @param teardown Called after each sample. Optional.
+ * @param state Passed to the callbacks.
+ */
+void bench_run(bench_runner *runner, const char *name, PFN_bench_setup setup, PFN_bench_run run, PFN_bench_teardown teardown, void *state);
+
+/**
+ * Writes every result so far to a JSON file, for comparing runs.
+ * @param runner The runner.
+ * @param path The file to write. Replaced if it exists.
+ * @returns true if the file was written.
+ */
+b8 bench_write_json(bench_runner *runner, const char *path);
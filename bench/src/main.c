@@ -0,0 +1,94 @@
+#include "bench.h"
+#include "suites/suites.h"
+
+#include <core/logger.h>
+#include <core/rcmemory.h>
+#include <core/rcstring.h>
+
+/**
+ * Usage: bench [--filter text] [--samples n] [--warmup n] [--min-sample-us n] [--json path]
+ *
+ * Runs every benchmark whose name contains the filter and logs the time per
+ * operation. With --json, also writes the results to a file so two builds can
+ * be compared.
+ */
+
+static b8 parse_u64(const char *text, u64 *out_value)
+{
+    u64 value = 0;
+    if (!text || !*text)
+    {
+        return false;
+    }
+    for (; *text; ++text)
+    {
+        if (*text < '0' || *text > '9')
+        {
+            return false;
+        }
+        value = value * 10 + (u64)(*text - '0');
+    }
+    *out_value = value;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    initialize_memory();
+
+    bench_options options = {0};
+    options.warmup_samples = BENCH_DEFAULT_WARMUP_SAMPLES;
+    const char *json_path = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : 0;
+        u64 number = 0;
+        if (strings_equal(arg, "--filter") && value)
+        {
+            options.filter = value;
+        }
+        else if (strings_equal(arg, "--json") && value)
+        {
+            json_path = value;
+        }
+        else if (strings_equal(arg, "--samples") && parse_u64(value, &number) && number > 0)
+        {
+            options.samples = (u32)number;
+        }
+        else if (strings_equal(arg, "--warmup") && parse_u64(value, &number))
+        {
+            options.warmup_samples = (u32)number;
+        }
+        else if (strings_equal(arg, "--min-sample-us") && parse_u64(value, &number) && number > 0)
+        {
+            options.min_sample_ns = number * 1000;
+        }
+        else
+        {
+            RCERROR("Unknown or incomplete argument '%s'.", arg);
+            RCERROR("Usage: bench [--filter text] [--samples n] [--warmup n] [--min-sample-us n] [--json path]");
+            return 1;
+        }
+        ++i;
+    }
+
+    bench_runner runner;
+    bench_runner_create(&options, &runner);
+
+    bench_suite_math(&runner);
+    bench_suite_darray(&runner);
+    bench_suite_memory(&runner);
+    bench_suite_event(&runner);
+
+    b8 ok = true;
+    if (json_path)
+    {
+        ok = bench_write_json(&runner, json_path);
+    }
+
+    bench_runner_destroy(&runner);
+    shutdown_memory();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+#include "suites.h"
+
+#include <containers/darray.h>
+
+// Length of the array that insert_at and pop_at shift through.
+#define DARRAY_BENCH_SHIFT_LENGTH 64
+
+typedef struct darray_state
+{
+    u64 *array;
+} darray_state;
+
+static void darray_teardown(void *state)
+{
+    darray_state *s = state;
+    darray_destroy(s->array);
+    s->array = 0;
+}
+
+static b8 setup_empty(void *state, u64 iterations)
+{
+    darray_state *s = state;
+    s->array = darray_create(u64);
+    return s->array != 0;
+}
+
+static b8 setup_reserved(void *state, u64 iterations)
+{
+    darray_state *s = state;
+    s->array = darray_reserve(u64, iterations);
+    return s->array != 0;
+}
+
+static b8 setup_full(void *state, u64 iterations)
+{
+    darray_state *s = state;
+    s->array = darray_reserve(u64, iterations);
+    if (!s->array)
+    {
+        return false;
+    }
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        s->array[i] = i;
+    }
+    darray_length_set(s->array, iterations);
+    return true;
+}
+
+static b8 setup_shift(void *state, u64 iterations)
+{
+    darray_state *s = state;
+    // Room to spare, so inserting never resizes.
+    s->array = darray_reserve(u64, DARRAY_BENCH_SHIFT_LENGTH * 2);
+    if (!s->array)
+    {
+        return false;
+    }
+    for (u64 i = 0; i < DARRAY_BENCH_SHIFT_LENGTH; ++i)
+    {
+        s->array[i] = i;
+    }
+    darray_length_set(s->array, DARRAY_BENCH_SHIFT_LENGTH);
+    return true;
+}
+
+static void run_push(void *state, u64 iterations)
+{
+    darray_state *s = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        darray_push(s->array, i);
+    }
+    BENCH_DO_NOT_OPTIMIZE(s->array[iterations - 1]);
+}
+
+static void run_pop(void *state, u64 iterations)
+{
+    darray_state *s = state;
+    u64 value;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        darray_pop(s->array, &value);
+        BENCH_DO_NOT_OPTIMIZE(value);
+    }
+}
+
+// Each operation inserts into the middle and removes it again, so the length stays put.
+static void run_insert_pop_at(void *state, u64 iterations)
+{
+    darray_state *s = state;
+    u64 index = DARRAY_BENCH_SHIFT_LENGTH / 2;
+    u64 value;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        darray_insert_at(s->array, index, i);
+        darray_pop_at(s->array, index, &value);
+        BENCH_DO_NOT_OPTIMIZE(value);
+    }
+}
+
+void bench_suite_darray(bench_runner *runner)
+{
+    darray_state state = {0};
+    bench_run(runner, "darray/push_growing", setup_empty, run_push, darray_teardown, &state);
+    bench_run(runner, "darray/push_reserved", setup_reserved, run_push, darray_teardown, &state);
+    bench_run(runner, "darray/pop", setup_full, run_pop, darray_teardown, &state);
+    bench_run(runner, "darray/insert_at_pop_at_64", setup_shift, run_insert_pop_at, darray_teardown, &state);
+}
@@ -0,0 +1,79 @@
+#include "suites.h"
+
+#include <core/event.h>
+#include <core/logger.h>
+
+// Codes from the application range, so no engine listener is involved.
+#define EVENT_BENCH_CODE 0x400
+#define EVENT_BENCH_MAX_LISTENERS 16
+
+typedef struct event_state
+{
+    u32 listener_count;
+    // One instance per listener; each counts its calls.
+    u64 calls[EVENT_BENCH_MAX_LISTENERS];
+} event_state;
+
+static b8 on_event(u16 code, void *sender, void *listener_inst, event_context data)
+{
+    u64 *calls = listener_inst;
+    (*calls)++;
+    // Unhandled, so every listener is called.
+    return false;
+}
+
+static b8 setup_listeners(void *state, u64 iterations)
+{
+    event_state *s = state;
+    for (u32 i = 0; i < s->listener_count; ++i)
+    {
+        if (!event_register(EVENT_BENCH_CODE, &s->calls[i], on_event))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void teardown_listeners(void *state)
+{
+    event_state *s = state;
+    for (u32 i = 0; i < s->listener_count; ++i)
+    {
+        event_unregister(EVENT_BENCH_CODE, &s->calls[i], on_event);
+    }
+}
+
+static void run_fire(void *state, u64 iterations)
+{
+    event_state *s = state;
+    event_context context = {0};
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        context.data.u64[0] = i;
+        b8 handled = event_fire(EVENT_BENCH_CODE, s, context);
+        BENCH_DO_NOT_OPTIMIZE(handled);
+    }
+}
+
+void bench_suite_event(bench_runner *runner)
+{
+    if (!event_initialize())
+    {
+        RCERROR("bench_suite_event - event system failed to initialize, skipping.");
+        return;
+    }
+
+    event_state state = {0};
+
+    state.listener_count = 0;
+    bench_run(runner, "event/fire_0_listeners", setup_listeners, run_fire, teardown_listeners, &state);
+    state.listener_count = 1;
+    bench_run(runner, "event/fire_1_listener", setup_listeners, run_fire, teardown_listeners, &state);
+    state.listener_count = 4;
+    bench_run(runner, "event/fire_4_listeners", setup_listeners, run_fire, teardown_listeners, &state);
+    state.listener_count = EVENT_BENCH_MAX_LISTENERS;
+    bench_run(runner, "event/fire_16_listeners", setup_listeners, run_fire, teardown_listeners, &state);
+
+    event_shutdown();
+}
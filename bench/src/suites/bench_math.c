@@ -0,0 +1,177 @@
+#include "suites.h"
+
+#include <math/rcmath.h>
+
+typedef struct math_inputs
+{
+    vec3 a;
+    vec3 b;
+    vec4 c;
+    vec4 d;
+    mat4 m;
+    mat4 n;
+    quat p;
+    quat q;
+    f32 x;
+} math_inputs;
+
+// The inputs are escaped on every iteration so each one is computed from scratch.
+
+static void run_vec3_normalized(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->a);
+        vec3 result = vec3_normalized(in->a);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_vec3_cross(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->a);
+        vec3 result = vec3_cross(in->a, in->b);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_vec3_distance(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->a);
+        f32 result = vec3_distance(in->a, in->b);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_vec4_dot(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->c);
+        f32 result = vec4_dot_f32(in->c.x, in->c.y, in->c.z, in->c.w, in->d.x, in->d.y, in->d.z, in->d.w);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_mat4_mul(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->m);
+        mat4 result = mat4_mul(in->m, in->n);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_mat4_inverse(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->m);
+        mat4 result = mat4_inverse(in->m);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_mat4_look_at(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->a);
+        mat4 result = mat4_look_at(in->a, in->b, vec3_up());
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_quat_mul(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->p);
+        quat result = quat_mul(in->p, in->q);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_quat_slerp(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->p);
+        quat result = quat_slerp(in->p, in->q, 0.3f);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_quat_to_mat4(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->p);
+        mat4 result = quat_to_mat4(in->p);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_rcsqrt(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->x);
+        f32 result = rcsqrt(in->x);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+static void run_rcsin(void *state, u64 iterations)
+{
+    math_inputs *in = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        BENCH_DO_NOT_OPTIMIZE(in->x);
+        f32 result = rcsin(in->x);
+        BENCH_DO_NOT_OPTIMIZE(result);
+    }
+}
+
+void bench_suite_math(bench_runner *runner)
+{
+    math_inputs in;
+    in.a = vec3_create(1.5f, -2.0f, 3.25f);
+    in.b = vec3_create(-0.5f, 4.0f, 1.0f);
+    in.c = vec4_create(1.0f, 2.0f, 3.0f, 4.0f);
+    in.d = vec4_create(-4.0f, 3.0f, -2.0f, 1.0f);
+    in.m = mat4_mul(mat4_euler_xyz(0.3f, 1.1f, -0.7f), mat4_translation(in.a));
+    in.n = mat4_perspective(deg_to_rad(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    in.p = quat_from_axis_angle(vec3_create(0.0f, 1.0f, 0.0f), 0.8f, true);
+    in.q = quat_from_axis_angle(vec3_normalized(in.a), -1.9f, true);
+    in.x = 2.75f;
+
+    bench_run(runner, "math/vec3_normalized", 0, run_vec3_normalized, 0, &in);
+    bench_run(runner, "math/vec3_cross", 0, run_vec3_cross, 0, &in);
+    bench_run(runner, "math/vec3_distance", 0, run_vec3_distance, 0, &in);
+    bench_run(runner, "math/vec4_dot_f32", 0, run_vec4_dot, 0, &in);
+    bench_run(runner, "math/mat4_mul", 0, run_mat4_mul, 0, &in);
+    bench_run(runner, "math/mat4_inverse", 0, run_mat4_inverse, 0, &in);
+    bench_run(runner, "math/mat4_look_at", 0, run_mat4_look_at, 0, &in);
+    bench_run(runner, "math/quat_mul", 0, run_quat_mul, 0, &in);
+    bench_run(runner, "math/quat_slerp", 0, run_quat_slerp, 0, &in);
+    bench_run(runner, "math/quat_to_mat4", 0, run_quat_to_mat4, 0, &in);
+    bench_run(runner, "math/rcsqrt", 0, run_rcsqrt, 0, &in);
+    bench_run(runner, "math/rcsin", 0, run_rcsin, 0, &in);
+}
@@ -0,0 +1,87 @@
+#include "suites.h"
+
+#include <core/rcmemory.h>
+#include <memory/linear_allocator.h>
+
+// Small enough to stay in cache; free_all zeroes the whole block.
+#define LINEAR_BENCH_BLOCK_SIZE (16 * 1024)
+
+typedef struct memory_state
+{
+    linear_allocator allocator;
+    u64 size;
+} memory_state;
+
+static b8 setup_linear(void *state, u64 iterations)
+{
+    memory_state *s = state;
+    linear_allocator_create(LINEAR_BENCH_BLOCK_SIZE, 0, &s->allocator);
+    return s->allocator.memory != 0;
+}
+
+static void teardown_linear(void *state)
+{
+    memory_state *s = state;
+    linear_allocator_destroy(&s->allocator);
+}
+
+static void run_linear_allocate(void *state, u64 iterations)
+{
+    memory_state *s = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        // Start over when full without free_all, whose zeroing would swamp the allocations.
+        if (s->allocator.allocated + s->size > s->allocator.total_size)
+        {
+            s->allocator.allocated = 0;
+        }
+        void *block = linear_allocator_allocate(&s->allocator, s->size);
+        BENCH_DO_NOT_OPTIMIZE(block);
+    }
+}
+
+// Fills the block with small allocations, then frees them all, once per operation.
+static void run_linear_fill_free_all(void *state, u64 iterations)
+{
+    memory_state *s = state;
+    u64 count = LINEAR_BENCH_BLOCK_SIZE / s->size;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        for (u64 j = 0; j < count; ++j)
+        {
+            void *block = linear_allocator_allocate(&s->allocator, s->size);
+            BENCH_DO_NOT_OPTIMIZE(block);
+        }
+        linear_allocator_free_all(&s->allocator);
+    }
+}
+
+static void run_rcallocate_free(void *state, u64 iterations)
+{
+    memory_state *s = state;
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        void *block = rcallocate(s->size, MEMORY_TAG_ARRAY);
+        BENCH_DO_NOT_OPTIMIZE(block);
+        rcfree(block, s->size, MEMORY_TAG_ARRAY);
+    }
+}
+
+void bench_suite_memory(bench_runner *runner)
+{
+    memory_state state = {0};
+
+    state.size = 16;
+    bench_run(runner, "linear_allocator/allocate_16", setup_linear, run_linear_allocate, teardown_linear, &state);
+    state.size = 256;
+    bench_run(runner, "linear_allocator/allocate_256", setup_linear, run_linear_allocate, teardown_linear, &state);
+    state.size = 64;
+    bench_run(runner, "linear_allocator/fill_free_all_16k", setup_linear, run_linear_fill_free_all, teardown_linear, &state);
+
+    state.size = 64;
+    bench_run(runner, "rcallocate/allocate_free_64", 0, run_rcallocate_free, 0, &state);
+    state.size = 4096;
+    bench_run(runner, "rcallocate/allocate_free_4k", 0, run_rcallocate_free, 0, &state);
+    state.size = 1024 * 1024;
+    bench_run(runner, "rcallocate/allocate_free_1m", 0, run_rcallocate_free, 0, &state);
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "bench.h"
+
+void bench_suite_math(bench_runner *runner);
+void bench_suite_darray(bench_runner *runner);
+void bench_suite_memory(bench_runner *runner);
+void bench_suite_event(bench_runner *runner);
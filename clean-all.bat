@@ -11,4 +11,8 @@ REM Testbed
 make -f "Makefile.testbed.windows.mak" clean
 IF %ERRORLEVEL% NEQ 0 (echo ERROR:%ERRORLEVEL% && exit)
 
+REM Bench
+make -f "Makefile.bench.windows.mak" clean
+IF %ERRORLEVEL% NEQ 0 (echo ERROR:%ERRORLEVEL% && exit)
+
 ECHO "All assemblies cleaned successfully."
\ No newline at end of file
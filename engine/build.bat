@@ -14,7 +14,7 @@ SET assembly=engine
 SET compilerFlags=-g -shared -Wvarargs -Wall -Werror
 REM -Wall -Werror
 SET includeFlags=-Isrc -I%VULKAN_SDK%/Include
-SET linkerFlags=-L%VULKAN_SDK%/Lib -luser32 -lvulkan-1
+SET linkerFlags=-L%VULKAN_SDK%/Lib -luser32 -lwinmm -lvulkan-1
 SET defines=-D_DEBUG -DRCEXPORT -D_CRT_SECURE_NO_WARNINGS
 
 ECHO "Building %assembly%. . ."
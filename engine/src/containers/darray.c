@@ -91,12 +91,13 @@ void *_darray_pop_at(void *array, u64 index, void *dest)
     rccopy_memory(dest, (void *)(addr + (stride * index)), stride);
 
     // If it's not the last element we're popping (which you should be if you use this method), cut out the entry and copy the rest inward.
+    // The ranges overlap, so this has to be a move rather than a copy.
     if (index != length - 1)
     {
-        rccopy_memory(
+        rcmove_memory(
             (void *)(addr + (index * stride)),
             (void *)(addr + ((index + 1) * stride)),
-            stride * (length - index));
+            stride * (length - index - 1));
     }
 
     _darray_field_set(array, DARRAY_LENGTH, length - 1);
@@ -121,14 +122,11 @@ void *_darray_insert_at(void *array, u64 index, void *value_ptr)
 
     u64 addr = (u64)array;
 
-    // If not inserting at the last element, copy the rest outward.
-    if (index != length - 1)
-    {
-        rccopy_memory(
-            (void *)(addr + ((index + 1) * stride)),
-            (void *)(addr + (index * stride)),
-            stride * (length - index));
-    }
+    // Move the element at index and everything after it outward. The ranges overlap.
+    rcmove_memory(
+        (void *)(addr + ((index + 1) * stride)),
+        (void *)(addr + (index * stride)),
+        stride * (length - index));
 
     rccopy_memory((void *)(addr + (stride * index)), value_ptr, stride);
 
@@ -5,8 +5,16 @@
 #include "platform/platform.h"
 #include "core/rcmemory.h"
 #include "core/event.h"
+#include "core/event_trace.h"
 #include "core/input.h"
+#include "core/input_recorder.h"
 #include "core/clock.h"
+#include "core/frame_pacer.h"
+#include "core/fixed_timestep.h"
+#include "core/frame_stats.h"
+#include "core/profiler.h"
+#include "core/rcstring.h"
+#include "core/string_builder.h"
 
 #include "renderer/renderer_frontend.h"
 
@@ -20,15 +28,30 @@ typedef struct application_state
     i16 height;
     clock clock;
     f64 last_time;
+    frame_pacer pacer;
+    b8 is_focused;
+    // The rate to pace to while focused; the pacer's target switches to background_frame_rate when not.
+    f64 foreground_frame_rate;
+    b8 use_fixed_timestep;
+    fixed_timestep timestep;
+    u64 last_time_ns;
+    frame_stats frame_stats;
+    b8 headless;
+    // The delta of every frame while input is played back, so runs are repeatable.
+    u64 playback_delta_ns;
 } application_state;
 
 static b8 initialized = false;
 static application_state app_state;
 
+// The playback delta when neither a fixed update rate nor a target frame rate is set.
+#define PLAYBACK_DEFAULT_FRAME_RATE 60.0
+
 // Event handlers
 b8 application_on_event(u16 code, void *sender, void *listener_inst, event_context context);
 b8 application_on_key(u16 code, void *sender, void *listener_inst, event_context context);
 b8 application_on_resized(u16 code, void *sender, void *listener_inst, event_context context);
+b8 application_on_focus_changed(u16 code, void *sender, void *listener_inst, event_context context);
 
 b8 application_create(game *game_inst)
 {
@@ -40,12 +63,20 @@ b8 application_create(game *game_inst)
 
     app_state.game_inst = game_inst;
 
-    // Initialize sub-systems.
+    // Initialize sub-systems. Strings first: every later system, and its threads, use them.
+    string_initialize();
     initialize_logging();
+    profiler_initialize();
+    profiler_set_thread_name("main");
+    if (game_inst->app_config.profiler_hardware_counters)
+    {
+        profiler_enable_counters(true);
+    }
     input_initialize();
 
     app_state.is_running = true;
     app_state.is_suspended = false;
+    app_state.is_focused = true;
 
     if (!event_initialize())
     {
@@ -57,22 +88,72 @@ b8 application_create(game *game_inst)
     event_register(EVENT_CODE_KEY_PRESSED, 0, application_on_key);
     event_register(EVENT_CODE_KEY_RELEASED, 0, application_on_key);
     event_register(EVENT_CODE_RESIZED, 0, application_on_resized);
+    event_register(EVENT_CODE_FOCUS_CHANGED, 0, application_on_focus_changed);
 
-    if (!platform_startup(
-            &app_state.platform,
-            game_inst->app_config.name,
-            game_inst->app_config.start_pos_x,
-            game_inst->app_config.start_pos_y,
-            game_inst->app_config.start_width,
-            game_inst->app_config.start_height))
+    // Start before the platform so the initial window size is part of the trace.
+    const application_config *config = &game_inst->app_config;
+    if (config->event_trace_replay_path)
     {
-        return false;
+        if (!event_trace_replay_begin(config->event_trace_replay_path, true))
+        {
+            RCERROR("Could not replay event trace '%s'.", config->event_trace_replay_path);
+            return false;
+        }
+    }
+    else if (config->event_trace_record_path)
+    {
+        if (!event_trace_record_begin(config->event_trace_record_path))
+        {
+            RCWARN("Could not record event trace to '%s', continuing without.", config->event_trace_record_path);
+        }
     }
 
-    if (!renderer_initialize(game_inst->app_config.name, &app_state.platform))
+    if (config->input_playback_path)
     {
-        RCFATAL("Renderer failed to initialize. Aborting application.");
-        return false;
+        if (config->event_trace_replay_path)
+        {
+            RCERROR("Cannot play back input and replay an event trace at the same time.");
+            return false;
+        }
+        if (!input_playback_begin(config->input_playback_path, true))
+        {
+            RCERROR("Could not play back input from '%s'.", config->input_playback_path);
+            return false;
+        }
+    }
+    else if (config->input_record_path)
+    {
+        if (!input_recording_begin(config->input_record_path))
+        {
+            RCWARN("Could not record input to '%s', continuing without.", config->input_record_path);
+        }
+    }
+
+    app_state.headless = config->headless;
+    if (app_state.headless)
+    {
+        // No window reports a size, so the game sees the configured one.
+        app_state.width = config->start_width;
+        app_state.height = config->start_height;
+    }
+    else
+    {
+        if (!platform_startup(
+                &app_state.platform,
+                game_inst->app_config.name,
+                game_inst->app_config.start_pos_x,
+                game_inst->app_config.start_pos_y,
+                game_inst->app_config.start_width,
+                game_inst->app_config.start_height))
+        {
+            return false;
+        }
+
+        if (!renderer_initialize(game_inst->app_config.name, &app_state.platform))
+        {
+            RCFATAL("Renderer failed to initialize. Aborting application.");
+            return false;
+        }
     }
 
     if (!app_state.game_inst->initialize(app_state.game_inst))
@@ -92,91 +173,244 @@ b8 application_run()
     clock_start(&app_state.clock);
     clock_update(&app_state.clock);
     app_state.last_time = app_state.clock.elapsed;
-    f64 running_time = 0;
-    u64 frame_count = 0;
-    f64 target_frame_seconds = 1.0f / 60;
+    app_state.last_time_ns = app_state.clock.elapsed_ns;
+    app_state.foreground_frame_rate = app_state.game_inst->app_config.target_frame_rate;
+    frame_pacer_init(&app_state.pacer, app_state.foreground_frame_rate);
+
+    application_config *config = &app_state.game_inst->app_config;
+    app_state.use_fixed_timestep = config->fixed_update_rate > 0;
+    if (app_state.use_fixed_timestep)
+    {
+        fixed_timestep_init(&app_state.timestep, config->fixed_update_rate, config->max_fixed_steps_per_frame);
+        // Exactly one step per frame.
+        app_state.playback_delta_ns = app_state.timestep.step_ns;
+    }
+    else
+    {
+        f64 playback_rate = config->target_frame_rate > 0 ? config->target_frame_rate : PLAYBACK_DEFAULT_FRAME_RATE;
+        app_state.playback_delta_ns = clock_seconds_to_ns(1.0 / playback_rate);
+    }
+
+    frame_stats_init(&app_state.frame_stats, config->frame_hitch_threshold_ms);
+    if (config->frame_stats_dump_path)
+    {
+        frame_stats_dump_begin(&app_state.frame_stats, config->frame_stats_dump_path, config->frame_stats_dump_interval);
+    }
 
-    RCINFO(get_mem_usage_str());
+    char mem_usage[8000];
+    string_builder mem_usage_builder;
+    string_builder_create(sizeof(mem_usage), mem_usage, &mem_usage_builder);
+    write_mem_usage_str(&mem_usage_builder);
+    RCINFO("%s", mem_usage);
 
     while (app_state.is_running)
     {
-        if (!platform_pump_messages(&app_state.platform))
+        // The frame's CPU time covers everything up to the pacer wait, message pumping and event dispatch included.
+        u64 frame_start_ns = platform_get_time_ns();
+        RC_PROFILE_BEGIN("application_run");
+
+        // When replaying, these raise the frame's recorded events and input.
+        event_trace_frame_begin();
+        input_recorder_frame_begin();
+
+        if (!app_state.headless && !platform_pump_messages(&app_state.platform))
         {
             app_state.is_running = false;
         }
 
-        if (!app_state.is_suspended)
+        // Deliver the input and other events posted while pumping, in batches.
+        event_dispatch_queued();
+
+        if (app_state.is_suspended)
+        {
+            // Nothing is drawn while minimized; sleep until the platform has something for us.
+            f64 background_rate = app_state.game_inst->app_config.background_frame_rate;
+            u64 wait_ms = background_rate > 0 ? (u64)(1000.0 / background_rate) : 100;
+            if (!app_state.headless)
+            {
+                platform_wait_for_events(&app_state.platform, wait_ms);
+            }
+
+            // Don't count the time spent suspended as frame time once resumed.
+            clock_update(&app_state.clock);
+            app_state.last_time = app_state.clock.elapsed;
+            app_state.last_time_ns = app_state.clock.elapsed_ns;
+        }
+        else
         {
             clock_update(&app_state.clock);
             f64 current_time = app_state.clock.elapsed;
             f64 delta = (current_time - app_state.last_time);
-            f64 frame_start_time = platform_get_absolute_time();
+            u64 delta_ns = app_state.clock.elapsed_ns - app_state.last_time_ns;
+            frame_stats_add(&app_state.frame_stats, delta_ns);
 
-            if (!app_state.game_inst->update(app_state.game_inst, (f32)delta))
+            // The stats keep the real frame time; the game gets the same delta on every run.
+            if (input_is_playing_back())
             {
-                RCFATAL("Game update failed, shutting down.");
-                app_state.is_running = false;
-                break;
+                delta_ns = app_state.playback_delta_ns;
+                delta = clock_ns_to_seconds(delta_ns);
             }
 
-            if (!app_state.game_inst->render(app_state.game_inst, (f32)delta))
+            f32 alpha = 1.0f;
+            if (app_state.use_fixed_timestep)
+            {
+                fixed_timestep *timestep = &app_state.timestep;
+                f32 step_seconds = fixed_timestep_step_seconds(timestep);
+                b8 update_failed = false;
+
+                fixed_timestep_begin_frame(timestep, delta_ns);
+                while (fixed_timestep_step(timestep))
+                {
+                    RC_PROFILE_SCOPE_COUNTERS("game update");
+                    if (!app_state.game_inst->update(app_state.game_inst, step_seconds))
+                    {
+                        update_failed = true;
+                        break;
+                    }
+
+                    // Advance input per step, so a press is seen by exactly one step and is kept
+                    // for the next frame if none ran this frame.
+                    input_update(step_seconds);
+                }
+
+                if (update_failed)
+                {
+                    RCFATAL("Game update failed, shutting down.");
+                    app_state.is_running = false;
+                    break;
+                }
+                alpha = fixed_timestep_alpha(timestep);
+            }
+            else
+            {
+                RC_PROFILE_BEGIN_COUNTERS("game update");
+                b8 updated = app_state.game_inst->update(app_state.game_inst, (f32)delta);
+                RC_PROFILE_END_COUNTERS();
+                if (!updated)
+                {
+                    RCFATAL("Game update failed, shutting down.");
+                    app_state.is_running = false;
+                    break;
+                }
+            }
+
+            RC_PROFILE_BEGIN("game render");
+            b8 rendered = app_state.game_inst->render(app_state.game_inst, (f32)delta, alpha);
+            RC_PROFILE_END();
+            if (!rendered)
             {
                 RCFATAL("Game render failed, shutting down.");
                 app_state.is_running = false;
                 break;
             }
 
-            // TODO: actual create a packet with real data
-            render_packet packet;
-            packet.delta_time = delta;
-            renderer_draw_frame(&packet);
-
-            // Calculations for how long the frame took
-            f64 frame_end_time = platform_get_absolute_time();
-            f64 frame_elapsed_time = frame_end_time - frame_start_time;
-            running_time += frame_elapsed_time;
-            f64 remaining_seconds = target_frame_seconds - frame_elapsed_time;
-
-            if (remaining_seconds > 0)
+            if (!app_state.headless)
             {
-                u64 remaining_ms = (remaining_seconds * 1000);
-
-                b8 limit_frames = false;
-                if (remaining_ms > 0 && limit_frames)
+                // TODO: actual create a packet with real data
+                render_packet packet;
+                packet.delta_time = delta;
+                packet.interpolation_alpha = alpha;
+                renderer_draw_frame(&packet);
+
+                u64 gpu_frame_ns = 0;
+                if (renderer_take_gpu_frame_time(&gpu_frame_ns))
                 {
-                    platform_sleep(remaining_ms - 1);
+                    frame_stats_add_gpu_time(&app_state.frame_stats, gpu_frame_ns);
                 }
-
-                frame_count++;
             }
 
             // input is processed at the end of the frame so that its output can be utilized next frame
-            input_update(delta);
-
-            app_state.last_time = current_time;
-            // TODO: remove
-            if (frame_count % 60 == 0 && running_time) // putting this bc the compiler will complain if we dont use these vars
+            if (!app_state.use_fixed_timestep)
             {
-                // RCDEBUG("Frames: %u, Running time: %f", frame_count, running_time);
+                input_update(delta);
             }
+
+            frame_stats_add_cpu_time(&app_state.frame_stats, platform_get_time_ns() - frame_start_ns);
+
+            // Hold the frame until the target rate's deadline.
+            RC_PROFILE_BEGIN("frame_pacer_wait");
+            frame_pacer_wait(&app_state.pacer);
+            RC_PROFILE_END();
+
+            app_state.last_time = current_time;
+            app_state.last_time_ns = app_state.clock.elapsed_ns;
         }
+
+        RC_PROFILE_END();
+        RC_PROFILE_FRAME_END();
     }
 
     app_state.is_running = false;
 
+    frame_stats_summary summary;
+    frame_stats_summarize(&app_state.frame_stats, &summary);
+    RCINFO(
+        "Frame times over the last %u frames: min %.2f ms, avg %.2f ms, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms. %llu hitches in %llu frames.",
+        summary.frame.sample_count,
+        clock_ns_to_ms(summary.frame.min_ns),
+        summary.frame.average_ns / RC_NS_PER_MS,
+        clock_ns_to_ms(summary.frame.p50_ns),
+        clock_ns_to_ms(summary.frame.p95_ns),
+        clock_ns_to_ms(summary.frame.p99_ns),
+        clock_ns_to_ms(summary.frame.max_ns),
+        summary.total_hitches,
+        summary.total_frames);
+    RCINFO(
+        "CPU time per frame: avg %.2f ms, p99 %.2f ms. GPU time per frame: avg %.2f ms, p99 %.2f ms (%u samples).",
+        summary.cpu.average_ns / RC_NS_PER_MS,
+        clock_ns_to_ms(summary.cpu.p99_ns),
+        summary.gpu.average_ns / RC_NS_PER_MS,
+        clock_ns_to_ms(summary.gpu.p99_ns),
+        summary.gpu.sample_count);
+    frame_stats_dump_end(&app_state.frame_stats);
+
     event_unregister(EVENT_CODE_APPLICATION_QUIT, 0, application_on_event);
     event_unregister(EVENT_CODE_KEY_PRESSED, 0, application_on_key);
     event_unregister(EVENT_CODE_KEY_RELEASED, 0, application_on_key);
     event_unregister(EVENT_CODE_RESIZED, 0, application_on_resized);
+    event_unregister(EVENT_CODE_FOCUS_CHANGED, 0, application_on_focus_changed);
     event_shutdown();
     input_shutdown();
 
-    renderer_shutdown();
-    platform_shutdown(&app_state.platform);
+    if (!app_state.headless)
+    {
+        renderer_shutdown();
+        platform_shutdown(&app_state.platform);
+    }
+    profiler_shutdown();
+    shutdown_logging();
 
     return true;
 }
 
+static void update_pacer_target()
+{
+    f64 background_rate = app_state.game_inst->app_config.background_frame_rate;
+    b8 use_background = !app_state.is_focused && background_rate > 0;
+    frame_pacer_set_target_rate(&app_state.pacer, use_background ? background_rate : app_state.foreground_frame_rate);
+}
+
+void application_set_target_frame_rate(f64 target_rate)
+{
+    app_state.foreground_frame_rate = target_rate;
+    update_pacer_target();
+}
+
+const frame_pacer_stats *application_get_frame_pacer_stats()
+{
+    return &app_state.pacer.stats;
+}
+
+void application_get_frame_stats(frame_stats_summary *out_summary)
+{
+    frame_stats_summarize(&app_state.frame_stats, out_summary);
+}
+
+const fixed_timestep_stats *application_get_fixed_timestep_stats()
+{
+    return app_state.use_fixed_timestep ? &app_state.timestep.stats : 0;
+}
+
 void application_get_framebuffer_size(u32 *width, u32 *height)
 {
     *width = app_state.width;
@@ -211,7 +445,20 @@ b8 application_on_key(u16 code, void *sender, void *listener_inst, event_context
 
             return true;
         }
-        else if (key_code == KEY_A)
+
+#if RCPROFILE_ENABLED
+        const application_config *config = &app_state.game_inst->app_config;
+        if (config->profiler_capture_key && key_code == config->profiler_capture_key)
+        {
+            if (!profiler_capture_trace(config->profiler_capture_path, config->profiler_capture_frames))
+            {
+                RCWARN("A profiler trace is already being written.");
+            }
+            return true;
+        }
+#endif
+
+        if (key_code == KEY_A)
         {
             RCDEBUG("Explicit check for the A key.");
         }
@@ -248,7 +495,7 @@ b8 application_on_resized(u16 code, void *sender, void *listener_inst, event_con
             app_state.width = width;
             app_state.height = height;
 
-            RCDEBUG("Window resize: %i %i", width, height);
+            RCLOG_LIMITED(PLATFORM, LOG_LEVEL_DEBUG, 5, "Window resize: %i %i", width, height);
 
             if (width == 0 || height == 0)
             {
@@ -265,10 +512,25 @@ b8 application_on_resized(u16 code, void *sender, void *listener_inst, event_con
                 }
 
                 app_state.game_inst->on_resize(app_state.game_inst, width, height);
-                renderer_on_resized(width, height);
+                if (!app_state.headless)
+                {
+                    renderer_on_resized(width, height);
+                }
             }
         }
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+b8 application_on_focus_changed(u16 code, void *sender, void *listener_inst, event_context context)
+{
+    b8 focused = context.data.u8[0] != 0;
+    if (focused != app_state.is_focused)
+    {
+        app_state.is_focused = focused;
+        update_pacer_target();
+    }
+
+    return false;
+}
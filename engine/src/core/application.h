@@ -3,6 +3,7 @@
 #include "defines.h"
 
 struct game;
+struct frame_stats_summary;
 typedef struct application_config
 {
     i16 start_pos_x;
@@ -10,9 +11,81 @@ typedef struct application_config
     i16 start_width;
     i16 start_height;
     char *name;
+
+    // If set, events are recorded to this file for later replay. See core/event_trace.h.
+    const char *event_trace_record_path;
+    // If set, events are replayed from this file instead of live input, and the application quits when it ends.
+    const char *event_trace_replay_path;
+
+    // If set, keyboard and mouse input is recorded to this file. See core/input_recorder.h.
+    const char *input_record_path;
+    // If set, input is played back from this file instead of the platform, and the application quits when it ends.
+    // Every frame of a playback advances the game by the same delta; see headless.
+    const char *input_playback_path;
+
+    // If set, no window or renderer is created and no platform messages are pumped: the main loop
+    // runs update and render only, with input from input_playback_path or an event trace replay.
+    // For benchmarks and automated runs. During an input playback each frame's delta is one fixed
+    // step, or one frame at target_frame_rate (60 per second if uncapped), instead of wall-clock time.
+    b8 headless;
+
+    // Frames per second to hold the main loop to; 0 for uncapped.
+    f64 target_frame_rate;
+    // Frames per second while the window is unfocused, and how often a minimized
+    // application wakes when no messages arrive. 0 to keep target_frame_rate when
+    // unfocused and wake 10 times a second when minimized.
+    f64 background_frame_rate;
+
+    // If set, update runs at this many fixed steps per second instead of once per frame,
+    // and render gets an alpha for interpolating between the last two steps.
+    f64 fixed_update_rate;
+    // The most fixed steps one frame may run to catch up; the rest are dropped. 0 for the default of
+    // FIXED_TIMESTEP_DEFAULT_MAX_STEPS; FIXED_TIMESTEP_UNLIMITED_STEPS for no limit. See core/fixed_timestep.h.
+    u32 max_fixed_steps_per_frame;
+
+    // Pressing this key (see keys in core/input.h) writes the last profiler_capture_frames frames
+    // of profiler zones to profiler_capture_path as a Chrome trace. 0 for no key. See core/profiler.h.
+    u16 profiler_capture_key;
+    // 0 for "profile_trace.json".
+    const char *profiler_capture_path;
+    // 0 for as many frames as the profiler keeps.
+    u32 profiler_capture_frames;
+    // If set, the profiler collects hardware counters for each frame and for the game update and
+    // renderer zones, where the platform allows. See profiler_enable_counters.
+    b8 profiler_hardware_counters;
+
+    // Frames longer than this are counted and logged as hitches. 0 for twice the recent average.
+    f64 frame_hitch_threshold_ms;
+    // If set, a row of frame time stats is written to this file every frame_stats_dump_interval
+    // seconds; CSV, or JSON Lines if the path ends in ".json". See core/frame_stats.h.
+    const char *frame_stats_dump_path;
+    // 0 for once a second.
+    f64 frame_stats_dump_interval;
 } application_config;
 
 RCAPI b8 application_create(struct game *game_inst);
 RCAPI b8 application_run();
 
+/**
+ * Changes the frame rate the main loop is held to.
+ * @param target_rate Frames per second; 0 for uncapped.
+ */
+RCAPI void application_set_target_frame_rate(f64 target_rate);
+
+/**
+ * @returns Stats on how closely frames met the target rate.
+ */
+RCAPI const struct frame_pacer_stats *application_get_frame_pacer_stats();
+
+/**
+ * Summarizes the recent frame times.
+ * @param out_summary Receives the summary.
+ */
+RCAPI void application_get_frame_stats(struct frame_stats_summary *out_summary);
+
+/**
+ * @returns Stats on fixed update steps, or 0 if the application is not using a fixed update rate.
+ */
+RCAPI const struct fixed_timestep_stats *application_get_fixed_timestep_stats();
+
 void application_get_framebuffer_size(u32 *width, u32 *height);
\ No newline at end of file
@@ -3,19 +3,34 @@
 
 void clock_update(clock *clock)
 {
-    if (clock->start_time != 0)
+    if (clock->start_ns != 0)
     {
-        clock->elapsed = platform_get_absolute_time() - clock->start_time;
+        clock->elapsed_ns = platform_get_time_ns() - clock->start_ns;
+        clock->elapsed = clock_ns_to_seconds(clock->elapsed_ns);
     }
 }
 
 void clock_start(clock *clock)
 {
-    clock->start_time = platform_get_absolute_time();
+    clock->start_ns = platform_get_time_ns();
+    clock->elapsed_ns = 0;
     clock->elapsed = 0;
 }
 
 void clock_stop(clock *clock)
 {
-    clock->start_time = 0;
-}
\ No newline at end of file
+    clock->start_ns = 0;
+}
+
+u64 clock_cycles_to_ns(u64 cycles)
+{
+    u64 frequency = platform_get_cycle_counter_frequency();
+    // Split to avoid overflowing cycles * 1e9.
+    return (cycles / frequency) * RC_NS_PER_SECOND + (cycles % frequency) * RC_NS_PER_SECOND / frequency;
+}
+
+u64 clock_ns_to_cycles(u64 ns)
+{
+    u64 frequency = platform_get_cycle_counter_frequency();
+    return (ns / RC_NS_PER_SECOND) * frequency + (ns % RC_NS_PER_SECOND) * frequency / RC_NS_PER_SECOND;
+}
@@ -2,9 +2,16 @@
 
 #include "defines.h"
 
+#define RC_NS_PER_SECOND 1000000000ull
+#define RC_NS_PER_MS 1000000ull
+#define RC_NS_PER_US 1000ull
+
 typedef struct clock
 {
-    f64 start_time;
+    // Monotonic nanoseconds at start, 0 if stopped.
+    u64 start_ns;
+    u64 elapsed_ns;
+    // elapsed_ns in seconds, for convenience.
     f64 elapsed;
 } clock;
 
@@ -21,4 +28,33 @@ void clock_start(clock *clock);
 /**
  * Stops the provided clock. Does not reset elapsed time.
  */
-void clock_stop(clock *clock);
\ No newline at end of file
+void clock_stop(clock *clock);
+
+RCINLINE f64 clock_ns_to_seconds(u64 ns)
+{
+    return (f64)ns / (f64)RC_NS_PER_SECOND;
+}
+
+RCINLINE f64 clock_ns_to_ms(u64 ns)
+{
+    return (f64)ns / (f64)RC_NS_PER_MS;
+}
+
+RCINLINE u64 clock_seconds_to_ns(f64 seconds)
+{
+    return seconds > 0 ? (u64)(seconds * (f64)RC_NS_PER_SECOND + 0.5) : 0;
+}
+
+/**
+ * Converts a span of platform_read_cycle_counter counts to nanoseconds.
+ * @param cycles The number of counts.
+ * @returns The span in nanoseconds.
+ */
+RCAPI u64 clock_cycles_to_ns(u64 cycles);
+
+/**
+ * Converts nanoseconds to a span of platform_read_cycle_counter counts.
+ * @param ns The span in nanoseconds.
+ * @returns The number of counts.
+ */
+RCAPI u64 clock_ns_to_cycles(u64 ns);
@@ -0,0 +1,148 @@
+#include "core/cpu.h"
+
+#if RCARCH_X64
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#include <stdatomic.h>
+
+// Set alongside the feature flags once detection has run.
+#define CPU_FEATURES_DETECTED 0x80000000u
+
+static _Atomic u32 features = 0;
+
+void cpu_cpuid(u32 leaf, u32 subleaf, u32 out_registers[4])
+{
+#if RCARCH_X64
+#if defined(_MSC_VER) && !defined(__clang__)
+    int registers[4];
+    __cpuidex(registers, (int)leaf, (int)subleaf);
+    out_registers[0] = (u32)registers[0];
+    out_registers[1] = (u32)registers[1];
+    out_registers[2] = (u32)registers[2];
+    out_registers[3] = (u32)registers[3];
+#else
+    __cpuid_count(leaf, subleaf, out_registers[0], out_registers[1], out_registers[2], out_registers[3]);
+#endif
+#else
+    out_registers[0] = out_registers[1] = out_registers[2] = out_registers[3] = 0;
+#endif
+}
+
+#if RCARCH_X64
+static u64 read_xcr0()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    u32 eax, edx;
+    __asm__ volatile("xgetbv"
+                     : "=a"(eax), "=d"(edx)
+                     : "c"(0));
+    return ((u64)edx << 32) | eax;
+#endif
+}
+#endif
+
+static u32 detect_features()
+{
+    u32 result = 0;
+
+#if RCARCH_X64
+    u32 regs[4];
+    cpu_cpuid(0, 0, regs);
+    u32 max_leaf = regs[0];
+
+    cpu_cpuid(1, 0, regs);
+    u32 ecx = regs[2];
+    u32 edx = regs[3];
+
+    if (edx & (1u << 26))
+    {
+        result |= CPU_FEATURE_SSE2;
+    }
+    if (ecx & (1u << 0))
+    {
+        result |= CPU_FEATURE_SSE3;
+    }
+    if (ecx & (1u << 9))
+    {
+        result |= CPU_FEATURE_SSSE3;
+    }
+    if (ecx & (1u << 19))
+    {
+        result |= CPU_FEATURE_SSE41;
+    }
+    if (ecx & (1u << 20))
+    {
+        result |= CPU_FEATURE_SSE42;
+    }
+    if (ecx & (1u << 23))
+    {
+        result |= CPU_FEATURE_POPCNT;
+    }
+
+    // AVX needs both the CPU bit and the OS saving XMM/YMM state on context switches.
+    b8 os_saves_ymm = false;
+    if ((ecx & (1u << 27)) && (ecx & (1u << 28)))
+    {
+        os_saves_ymm = (read_xcr0() & 0x6) == 0x6;
+        if (os_saves_ymm)
+        {
+            result |= CPU_FEATURE_AVX;
+        }
+    }
+
+    if (max_leaf >= 7)
+    {
+        cpu_cpuid(7, 0, regs);
+        u32 ebx = regs[1];
+        if ((ebx & (1u << 5)) && os_saves_ymm)
+        {
+            result |= CPU_FEATURE_AVX2;
+        }
+        if (ebx & (1u << 3))
+        {
+            result |= CPU_FEATURE_BMI1;
+        }
+        if (ebx & (1u << 8))
+        {
+            result |= CPU_FEATURE_BMI2;
+        }
+    }
+
+    cpu_cpuid(0x80000000, 0, regs);
+    if (regs[0] >= 0x80000007)
+    {
+        cpu_cpuid(0x80000007, 0, regs);
+        if (regs[3] & (1u << 8))
+        {
+            result |= CPU_FEATURE_INVARIANT_TSC;
+        }
+    }
+#endif
+
+    return result;
+}
+
+u32 cpu_features_get()
+{
+    u32 result = atomic_load_explicit(&features, memory_order_relaxed);
+    if (!(result & CPU_FEATURES_DETECTED))
+    {
+        // Detection always gives the same answer, so threads racing here store the same value.
+        result = detect_features() | CPU_FEATURES_DETECTED;
+        atomic_store_explicit(&features, result, memory_order_relaxed);
+    }
+
+    return result & ~CPU_FEATURES_DETECTED;
+}
+
+b8 cpu_has_feature(cpu_feature feature)
+{
+    return (cpu_features_get() & feature) == (u32)feature;
+}
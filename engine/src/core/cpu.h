@@ -0,0 +1,50 @@
+#pragma once
+
+#include "defines.h"
+
+typedef enum cpu_feature
+{
+    CPU_FEATURE_SSE2 = 0x01,
+    CPU_FEATURE_SSE3 = 0x02,
+    CPU_FEATURE_SSSE3 = 0x04,
+    CPU_FEATURE_SSE41 = 0x08,
+    CPU_FEATURE_SSE42 = 0x10,
+    CPU_FEATURE_POPCNT = 0x20,
+    CPU_FEATURE_AVX = 0x40,
+    CPU_FEATURE_AVX2 = 0x80,
+    CPU_FEATURE_BMI1 = 0x100,
+    CPU_FEATURE_BMI2 = 0x200,
+    // The time stamp counter runs at a constant rate across power states.
+    CPU_FEATURE_INVARIANT_TSC = 0x400
+} cpu_feature;
+
+/**
+ * Marks a function as compiled for AVX2 regardless of the global target, so it
+ * can live next to the baseline code and be selected at runtime.
+ */
+#if defined(__clang__) || defined(__GNUC__)
+#define RCTARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define RCTARGET_AVX2
+#endif
+
+/**
+ * Returns the cpu_feature flags supported by this machine. AVX and AVX2 are only
+ * reported when the OS also saves the YMM registers. Detected once, then cached.
+ */
+RCAPI u32 cpu_features_get();
+
+/**
+ * Indicates if the given feature is supported.
+ * @param feature The cpu_feature to check.
+ * @returns true if supported; otherwise false.
+ */
+RCAPI b8 cpu_has_feature(cpu_feature feature);
+
+/**
+ * Executes cpuid for the given leaf/subleaf. Zeroes out_registers on non-x64 targets.
+ * @param leaf The cpuid leaf (eax).
+ * @param subleaf The cpuid subleaf (ecx).
+ * @param out_registers Receives eax, ebx, ecx, edx in that order.
+ */
+RCAPI void cpu_cpuid(u32 leaf, u32 subleaf, u32 out_registers[4]);
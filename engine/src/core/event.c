@@ -1,27 +1,266 @@
 #include "core/event.h"
+#include "core/event_trace.h"
 #include "core/rcmemory.h"
+#include "core/logger.h"
 #include "containers/darray.h"
+#include "memory/linear_allocator.h"
+
+#include <stdatomic.h>
 
 typedef struct registered_event
 {
     void *listener;
     PFN_on_event callback;
+    i32 priority;
 } registered_event;
 
+/**
+ * Every listener of every code in one allocation, grouped by code and sorted by
+ * descending priority within a code. Immutable once published: registration
+ * builds a new pool instead of editing in place, so a dispatch that already
+ * holds one keeps a valid view even if a callback registers or unregisters.
+ */
+typedef struct listener_pool
+{
+    u64 count;
+    registered_event listeners[];
+} listener_pool;
+
+/* Dense per-code record, created the first time a code is registered or configured. */
 typedef struct event_code_entry
 {
-    registered_event *events;
+    // This code's range in the listener pool.
+    u32 first_listener;
+    u32 listener_count;
+    PFN_event_merge merge;
+    // Sequence number of this code's newest queued event, for coalescing.
+    u32 pending_sequence;
+    u8 coalesce_policy;
 } event_code_entry;
 
 #define MAX_MESSAGE_CODES 16384
+// The sparse code -> slot map is split into pages, allocated when a code in their range is first used.
+#define EVENT_CODE_PAGE_SIZE 256
+#define EVENT_CODE_PAGE_COUNT (MAX_MESSAGE_CODES / EVENT_CODE_PAGE_SIZE)
+
+// Must be a power of 2.
+#define EVENT_QUEUE_CAPACITY 1024
+#define EVENT_QUEUE_MASK (EVENT_QUEUE_CAPACITY - 1)
+
+// Size of each of the two payload arenas, i.e. the payload bytes that can be queued per frame.
+#define EVENT_PAYLOAD_ARENA_SIZE (64 * 1024)
+
+// Number of non-main threads that can post. Each gets its own queue on first post.
+#define EVENT_MAX_THREAD_QUEUES 16
+// Must be a power of 2.
+#define EVENT_THREAD_QUEUE_CAPACITY 256
+#define EVENT_THREAD_QUEUE_MASK (EVENT_THREAD_QUEUE_CAPACITY - 1)
+
+typedef struct queued_event
+{
+    u16 code;
+    void *sender;
+    event_context context;
+} queued_event;
+
+/**
+ * Single-producer/single-consumer ring owned by one worker thread and drained
+ * by the main thread. The indices sit on separate cache lines so the producer
+ * and consumer do not contend.
+ */
+typedef struct thread_event_queue
+{
+    // Written by the owning thread.
+    _Atomic u32 tail;
+    u8 tail_padding[60];
+    // Written by the main thread.
+    _Atomic u32 head;
+    u8 head_padding[60];
+    queued_event events[EVENT_THREAD_QUEUE_CAPACITY];
+} thread_event_queue;
 
 typedef struct event_system_state
 {
-    event_code_entry registered[MAX_MESSAGE_CODES];
+    /* Sparse code -> dense slot map. Pages hold slot index + 1, or 0 for unused codes. */
+    u16 *code_pages[EVENT_CODE_PAGE_COUNT];
+    // darray of per-code entries, indexed by slot.
+    event_code_entry *entries;
+    listener_pool *pool;
+
+    /**
+     * Ring buffer of events posted for deferred dispatch. Main thread only.
+     * queue_head is a running sequence number; an event's slot is its sequence
+     * masked by EVENT_QUEUE_MASK.
+     */
+    queued_event *queue;
+    u32 queue_head;
+    u32 queue_count;
+    b8 queue_overflow_warned;
+
+    /**
+     * Coalescing window. An event may only merge into a pending one queued at
+     * or after both of these: coalesce_floor excludes events a running
+     * dispatch has already taken, ordered_end excludes anything queued before
+     * the most recent non-coalescing event so merges never reorder across it.
+     */
+    u32 coalesce_floor;
+    u32 ordered_end;
+
+    /**
+     * Payloads from event_post_payload. New posts go to the active arena; each
+     * dispatch switches arenas and resets the new active one, which was last
+     * filled two dispatches ago and has been delivered since.
+     */
+    linear_allocator payload_arenas[2];
+    u32 active_payload_arena;
+    b8 payload_overflow_warned;
+
+    /* Per-thread posting queues, claimed by worker threads on first post. */
+    thread_event_queue *thread_queues;
+    _Atomic u32 thread_queues_claimed;
+    _Atomic u32 thread_posts_dropped;
+    // Bumped on every initialize so threads drop queue pointers from a previous run.
+    u32 generation;
+
+    /* Listener pools replaced while a dispatch was running, freed once it ends. */
+    u32 dispatch_depth;
+    listener_pool **retired_pools;
 } event_system_state;
 
 static b8 is_initialized = false;
 static event_system_state state;
+static u32 generation_counter = 0;
+
+static RCTHREAD_LOCAL b8 is_main_thread = false;
+static RCTHREAD_LOCAL thread_event_queue *local_queue = 0;
+static RCTHREAD_LOCAL u32 local_queue_generation = 0;
+
+static u64 listener_pool_size(u64 count)
+{
+    return sizeof(listener_pool) + sizeof(registered_event) * count;
+}
+
+static listener_pool *listener_pool_create(u64 count)
+{
+    listener_pool *pool = rcallocate(listener_pool_size(count), MEMORY_TAG_ARRAY);
+    pool->count = count;
+    return pool;
+}
+
+static void listener_pool_destroy(listener_pool *pool)
+{
+    rcfree(pool, listener_pool_size(pool->count), MEMORY_TAG_ARRAY);
+}
+
+/**
+ * Makes a new pool current. The old one is freed now if no dispatch can be
+ * reading it, otherwise when the outermost dispatch ends.
+ */
+static void listener_pool_publish(listener_pool *pool)
+{
+    listener_pool *old = state.pool;
+    state.pool = pool;
+    if (!old)
+    {
+        return;
+    }
+
+    if (state.dispatch_depth == 0)
+    {
+        listener_pool_destroy(old);
+    }
+    else
+    {
+        darray_push(state.retired_pools, old);
+    }
+}
+
+static void destroy_retired_pools()
+{
+    u64 retired_count = darray_length(state.retired_pools);
+    for (u64 i = 0; i < retired_count; ++i)
+    {
+        listener_pool_destroy(state.retired_pools[i]);
+    }
+    darray_clear(state.retired_pools);
+}
+
+static event_code_entry *entry_find(u16 code)
+{
+    if (code >= MAX_MESSAGE_CODES)
+    {
+        return 0;
+    }
+
+    const u16 *page = state.code_pages[code / EVENT_CODE_PAGE_SIZE];
+    if (page == 0)
+    {
+        return 0;
+    }
+
+    u16 slot = page[code % EVENT_CODE_PAGE_SIZE];
+    return slot ? &state.entries[slot - 1] : 0;
+}
+
+/**
+ * Returns the entry for a code, creating it if needed. Creating an entry can
+ * move the others, so pointers from earlier calls must not be kept.
+ */
+static event_code_entry *entry_get_or_create(u16 code)
+{
+    u16 **page = &state.code_pages[code / EVENT_CODE_PAGE_SIZE];
+    if (*page == 0)
+    {
+        *page = rcallocate(sizeof(u16) * EVENT_CODE_PAGE_SIZE, MEMORY_TAG_ARRAY);
+    }
+
+    u16 *slot = &(*page)[code % EVENT_CODE_PAGE_SIZE];
+    if (*slot == 0)
+    {
+        event_code_entry entry = {0};
+        // An empty range can sit anywhere; the end of the pool is as good as any.
+        entry.first_listener = state.pool ? (u32)state.pool->count : 0;
+        // Point before the queue so nothing already queued is treated as pending.
+        entry.pending_sequence = state.queue_head - 1;
+        darray_push(state.entries, entry);
+        *slot = (u16)darray_length(state.entries);
+    }
+
+    return &state.entries[*slot - 1];
+}
+
+RCINLINE void dispatch_begin()
+{
+    state.dispatch_depth++;
+}
+
+static void dispatch_end()
+{
+    state.dispatch_depth--;
+    if (state.dispatch_depth == 0)
+    {
+        destroy_retired_pools();
+    }
+}
+
+RCINLINE b8 sequence_at_or_after(u32 sequence, u32 start)
+{
+    return (i32)(sequence - start) >= 0;
+}
+
+static void merge_mouse_wheel(u16 code, event_context *pending, event_context incoming)
+{
+    i32 z_delta = (i32)pending->data.i8[0] + (i32)incoming.data.i8[0];
+    if (z_delta > 127)
+    {
+        z_delta = 127;
+    }
+    else if (z_delta < -128)
+    {
+        z_delta = -128;
+    }
+    pending->data.i8[0] = (i8)z_delta;
+}
 
 b8 event_initialize()
 {
@@ -32,48 +271,134 @@ b8 event_initialize()
 
     is_initialized = false;
     rczero_memory(&state, sizeof(state));
+    state.queue = rcallocate(sizeof(queued_event) * EVENT_QUEUE_CAPACITY, MEMORY_TAG_RING_QUEUE);
+    state.thread_queues = rcallocate(sizeof(thread_event_queue) * EVENT_MAX_THREAD_QUEUES, MEMORY_TAG_RING_QUEUE);
+    state.entries = darray_create(event_code_entry);
+    state.retired_pools = darray_create(listener_pool *);
+    linear_allocator_create(EVENT_PAYLOAD_ARENA_SIZE, 0, &state.payload_arenas[0]);
+    linear_allocator_create(EVENT_PAYLOAD_ARENA_SIZE, 0, &state.payload_arenas[1]);
+    state.generation = ++generation_counter;
+
+    // The initializing thread is the one allowed to fire, register and dispatch.
+    is_main_thread = true;
     is_initialized = true;
+
+    // High-frequency input only needs to reach listeners once per frame.
+    event_set_coalesce_policy(EVENT_CODE_MOUSE_MOVED, EVENT_COALESCE_LATEST, 0);
+    event_set_coalesce_policy(EVENT_CODE_RESIZED, EVENT_COALESCE_LATEST, 0);
+    event_set_coalesce_policy(EVENT_CODE_FOCUS_CHANGED, EVENT_COALESCE_LATEST, 0);
+    event_set_coalesce_policy(EVENT_CODE_MOUSE_WHEEL, EVENT_COALESCE_MERGE, merge_mouse_wheel);
     return true;
 }
 
 void event_shutdown()
 {
-    for (u16 i = 0; i < MAX_MESSAGE_CODES; ++i)
+    event_trace_shutdown();
+
+    if (state.pool)
+    {
+        listener_pool_destroy(state.pool);
+        state.pool = 0;
+    }
+
+    if (state.retired_pools)
+    {
+        destroy_retired_pools();
+        darray_destroy(state.retired_pools);
+        state.retired_pools = 0;
+    }
+
+    if (state.entries)
+    {
+        darray_destroy(state.entries);
+        state.entries = 0;
+    }
+
+    for (u32 i = 0; i < EVENT_CODE_PAGE_COUNT; ++i)
     {
-        if (state.registered[i].events != 0)
+        if (state.code_pages[i])
         {
-            darray_destroy(state.registered[i].events);
-            state.registered[i].events = 0;
+            rcfree(state.code_pages[i], sizeof(u16) * EVENT_CODE_PAGE_SIZE, MEMORY_TAG_ARRAY);
+            state.code_pages[i] = 0;
         }
     }
+
+    if (state.queue)
+    {
+        rcfree(state.queue, sizeof(queued_event) * EVENT_QUEUE_CAPACITY, MEMORY_TAG_RING_QUEUE);
+        state.queue = 0;
+    }
+    state.queue_head = 0;
+    state.queue_count = 0;
+    state.coalesce_floor = 0;
+    state.ordered_end = 0;
+
+    linear_allocator_destroy(&state.payload_arenas[0]);
+    linear_allocator_destroy(&state.payload_arenas[1]);
+
+    if (state.thread_queues)
+    {
+        rcfree(state.thread_queues, sizeof(thread_event_queue) * EVENT_MAX_THREAD_QUEUES, MEMORY_TAG_RING_QUEUE);
+        state.thread_queues = 0;
+    }
+
+    is_initialized = false;
 }
 
 b8 event_register(u16 code, void *listener, PFN_on_event on_event)
 {
-    if (is_initialized == false)
+    return event_register_priority(code, listener, on_event, 0);
+}
+
+b8 event_register_priority(u16 code, void *listener, PFN_on_event on_event, i32 priority)
+{
+    if (is_initialized == false || code >= MAX_MESSAGE_CODES)
     {
         return false;
     }
 
-    if (state.registered[code].events == 0)
-    {
-        state.registered[code].events = darray_create(registered_event);
-    }
+    event_code_entry *entry = entry_get_or_create(code);
+    const registered_event *existing = state.pool ? state.pool->listeners + entry->first_listener : 0;
 
-    u64 registered_count = darray_length(state.registered[code].events);
-    for (u64 i = 0; i < registered_count; ++i)
+    // Insert after every listener of equal or higher priority, so ties keep registration order.
+    u32 insert_index = entry->listener_count;
+    for (u32 i = 0; i < entry->listener_count; ++i)
     {
-        if (state.registered[code].events[i].listener == listener)
+        if (existing[i].listener == listener)
         {
             // TODO: warn
             return false;
         }
+        if (insert_index == entry->listener_count && existing[i].priority < priority)
+        {
+            insert_index = i;
+        }
     }
 
-    registered_event event;
-    event.listener = listener;
-    event.callback = on_event;
-    darray_push(state.registered[code].events, event);
+    u64 old_count = state.pool ? state.pool->count : 0;
+    u32 position = entry->first_listener + insert_index;
+    listener_pool *updated = listener_pool_create(old_count + 1);
+    if (old_count)
+    {
+        rccopy_memory(updated->listeners, state.pool->listeners, sizeof(registered_event) * position);
+        rccopy_memory(updated->listeners + position + 1, state.pool->listeners + position, sizeof(registered_event) * (old_count - position));
+    }
+    updated->listeners[position].listener = listener;
+    updated->listeners[position].callback = on_event;
+    updated->listeners[position].priority = priority;
+
+    // Ranges at or after the insertion point move up by one.
+    u64 entry_count = darray_length(state.entries);
+    for (u64 i = 0; i < entry_count; ++i)
+    {
+        if (&state.entries[i] != entry && state.entries[i].first_listener >= position)
+        {
+            state.entries[i].first_listener++;
+        }
+    }
+    entry->listener_count++;
+
+    listener_pool_publish(updated);
     return true;
 }
 
@@ -84,20 +409,39 @@ b8 event_unregister(u16 code, void *listener, PFN_on_event on_event)
         return false;
     }
 
-    if (state.registered[code].events == 0)
+    event_code_entry *entry = entry_find(code);
+    if (entry == 0 || entry->listener_count == 0)
     {
         // TODO: warn
         return false;
     }
 
-    u64 registered_count = darray_length(state.registered[code].events);
-    for (u64 i = 0; i < registered_count; ++i)
+    const registered_event *existing = state.pool->listeners + entry->first_listener;
+    for (u32 i = 0; i < entry->listener_count; ++i)
     {
-        registered_event e = state.registered[code].events[i];
-        if (e.listener == listener && e.callback == on_event)
+        if (existing[i].listener == listener && existing[i].callback == on_event)
         {
-            registered_event popped_event;
-            darray_pop_at(state.registered[code].events, i, &popped_event);
+            u64 old_count = state.pool->count;
+            u32 position = entry->first_listener + i;
+            listener_pool *updated = 0;
+            if (old_count > 1)
+            {
+                updated = listener_pool_create(old_count - 1);
+                rccopy_memory(updated->listeners, state.pool->listeners, sizeof(registered_event) * position);
+                rccopy_memory(updated->listeners + position, state.pool->listeners + position + 1, sizeof(registered_event) * (old_count - position - 1));
+            }
+
+            u64 entry_count = darray_length(state.entries);
+            for (u64 e = 0; e < entry_count; ++e)
+            {
+                if (state.entries[e].first_listener > position)
+                {
+                    state.entries[e].first_listener--;
+                }
+            }
+            entry->listener_count--;
+
+            listener_pool_publish(updated);
             return true;
         }
     }
@@ -105,28 +449,377 @@ b8 event_unregister(u16 code, void *listener, PFN_on_event on_event)
     return false;
 }
 
-b8 event_fire(u16 code, void *sender, event_context context)
+b8 event_set_coalesce_policy(u16 code, event_coalesce_policy policy, PFN_event_merge merge)
 {
-    if (is_initialized == false)
+    if (is_initialized == false || code >= MAX_MESSAGE_CODES)
     {
         return false;
     }
 
-    if (state.registered[code].events == 0)
+    if (policy == EVENT_COALESCE_MERGE && merge == 0)
     {
+        RCERROR("event_set_coalesce_policy - EVENT_COALESCE_MERGE requires a merge callback.");
         return false;
     }
 
-    u64 registered_count = darray_length(state.registered[code].events);
-    for (u64 i = 0; i < registered_count; ++i)
+    event_code_entry *entry = entry_get_or_create(code);
+    entry->coalesce_policy = (u8)policy;
+    entry->merge = policy == EVENT_COALESCE_MERGE ? merge : 0;
+    // Point before the queue so an event queued under the old policy is never merged into.
+    entry->pending_sequence = state.queue_head - 1;
+    return true;
+}
+
+/**
+ * Whether an event raised now comes from outside the event system. Only those
+ * go to the trace; events raised by listeners are recreated on replay.
+ */
+RCINLINE b8 is_external_event()
+{
+    return state.dispatch_depth == 0;
+}
+
+static b8 fire_listeners(u16 code, void *sender, event_context context)
+{
+    const event_code_entry *entry = entry_find(code);
+    if (entry == 0 || entry->listener_count == 0)
     {
-        registered_event e = state.registered[code].events[i];
+        return false;
+    }
+
+    // A snapshot; stays valid even if a callback changes the listeners.
+    const registered_event *listeners = state.pool->listeners + entry->first_listener;
+    u32 listener_count = entry->listener_count;
+
+    dispatch_begin();
+
+    b8 handled = false;
+    for (u32 i = 0; i < listener_count; ++i)
+    {
+        registered_event e = listeners[i];
         if (e.callback(code, sender, e.listener, context))
         {
             // This check ends once the first listener handles the message. It does not continue notifying other listeners.
-            return true;
+            handled = true;
+            break;
         }
     }
 
-    return false;
-}
\ No newline at end of file
+    dispatch_end();
+    return handled;
+}
+
+b8 event_fire(u16 code, void *sender, event_context context)
+{
+    if (is_initialized == false)
+    {
+        return false;
+    }
+
+    if (is_external_event() && !event_trace_capture(code, sender, context, 0, false))
+    {
+        return false;
+    }
+
+    return fire_listeners(code, sender, context);
+}
+
+static b8 event_post_from_thread(u16 code, void *sender, event_context context)
+{
+    if (local_queue == 0 || local_queue_generation != state.generation)
+    {
+        u32 index = atomic_fetch_add_explicit(&state.thread_queues_claimed, 1, memory_order_relaxed);
+        if (index >= EVENT_MAX_THREAD_QUEUES)
+        {
+            atomic_fetch_add_explicit(&state.thread_posts_dropped, 1, memory_order_relaxed);
+            return false;
+        }
+
+        local_queue = &state.thread_queues[index];
+        local_queue_generation = state.generation;
+    }
+
+    u32 tail = atomic_load_explicit(&local_queue->tail, memory_order_relaxed);
+    u32 head = atomic_load_explicit(&local_queue->head, memory_order_acquire);
+    if (tail - head == EVENT_THREAD_QUEUE_CAPACITY)
+    {
+        atomic_fetch_add_explicit(&state.thread_posts_dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    queued_event *entry = &local_queue->events[tail & EVENT_THREAD_QUEUE_MASK];
+    entry->code = code;
+    entry->sender = sender;
+    entry->context = context;
+
+    // Publish the entry to the main thread.
+    atomic_store_explicit(&local_queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * Folds an event into the pending event of the same code if its policy allows
+ * and that event is still inside the coalescing window.
+ * @returns true if the event was merged and must not be queued.
+ */
+static b8 try_coalesce(u16 code, void *sender, event_context context)
+{
+    event_code_entry *entry = entry_find(code);
+    if (entry == 0 || entry->coalesce_policy == EVENT_COALESCE_NONE)
+    {
+        return false;
+    }
+
+    u32 sequence = entry->pending_sequence;
+    u32 tail = state.queue_head + state.queue_count;
+    if (!sequence_at_or_after(sequence, state.coalesce_floor) || !sequence_at_or_after(sequence, state.ordered_end) || sequence_at_or_after(sequence, tail))
+    {
+        return false;
+    }
+
+    queued_event *pending = &state.queue[sequence & EVENT_QUEUE_MASK];
+    if (pending->code != code)
+    {
+        // A stale sequence number that wrapped back into range.
+        return false;
+    }
+
+    pending->sender = sender;
+    if (entry->coalesce_policy == EVENT_COALESCE_LATEST)
+    {
+        pending->context = context;
+    }
+    else
+    {
+        entry->merge(code, &pending->context, context);
+    }
+    return true;
+}
+
+static void queue_push(u16 code, void *sender, event_context context)
+{
+    u32 sequence = state.queue_head + state.queue_count;
+    queued_event *entry = &state.queue[sequence & EVENT_QUEUE_MASK];
+    entry->code = code;
+    entry->sender = sender;
+    entry->context = context;
+    state.queue_count++;
+
+    event_code_entry *code_entry = entry_find(code);
+    if (code_entry == 0 || code_entry->coalesce_policy == EVENT_COALESCE_NONE)
+    {
+        state.ordered_end = sequence + 1;
+    }
+    else
+    {
+        code_entry->pending_sequence = sequence;
+    }
+}
+
+/**
+ * Queues an event on the main thread, coalescing it if its policy allows.
+ * Fires it immediately if the queue is full.
+ */
+static void queue_event(u16 code, void *sender, event_context context)
+{
+    if (try_coalesce(code, sender, context))
+    {
+        return;
+    }
+
+    if (state.queue_count == EVENT_QUEUE_CAPACITY)
+    {
+        // Never drop events; deliver immediately instead when the frame's queue is full.
+        if (!state.queue_overflow_warned)
+        {
+            RCWARN("event_post - queue full (%u events), falling back to immediate dispatch.", EVENT_QUEUE_CAPACITY);
+            state.queue_overflow_warned = true;
+        }
+        fire_listeners(code, sender, context);
+        return;
+    }
+
+    queue_push(code, sender, context);
+}
+
+b8 event_post(u16 code, void *sender, event_context context)
+{
+    if (is_initialized == false)
+    {
+        return false;
+    }
+
+    if (!is_main_thread)
+    {
+        return event_post_from_thread(code, sender, context);
+    }
+
+    if (is_external_event() && !event_trace_capture(code, sender, context, 0, true))
+    {
+        return false;
+    }
+
+    queue_event(code, sender, context);
+    return true;
+}
+
+b8 event_post_payload(u16 code, void *sender, const void *data, u64 size)
+{
+    if (is_initialized == false || !is_main_thread)
+    {
+        return false;
+    }
+
+    event_context context;
+    context.data.payload.data = data;
+    context.data.payload.size = size;
+
+    if (is_external_event() && !event_trace_capture(code, sender, context, data, true))
+    {
+        return false;
+    }
+
+    // Keep every payload 8-byte aligned.
+    u64 aligned_size = (size + 7) & ~(u64)7;
+    linear_allocator *arena = &state.payload_arenas[state.active_payload_arena];
+    if (arena->allocated + aligned_size > arena->total_size)
+    {
+        if (!state.payload_overflow_warned)
+        {
+            RCWARN("event_post_payload - payload arena full (%u bytes), falling back to immediate dispatch.", EVENT_PAYLOAD_ARENA_SIZE);
+            state.payload_overflow_warned = true;
+        }
+        fire_listeners(code, sender, context);
+        return true;
+    }
+
+    if (size)
+    {
+        void *copy = linear_allocator_allocate(arena, aligned_size);
+        rccopy_memory(copy, data, size);
+        context.data.payload.data = copy;
+    }
+
+    queue_event(code, sender, context);
+    return true;
+}
+
+/**
+ * Moves events posted by worker threads onto the main queue, after anything
+ * the main thread posted, coalescing them the same way. Stops early if the
+ * main queue fills up; the rest stays in the thread queues for the next frame.
+ */
+static void drain_thread_queues()
+{
+    u32 claimed = atomic_load_explicit(&state.thread_queues_claimed, memory_order_acquire);
+    if (claimed > EVENT_MAX_THREAD_QUEUES)
+    {
+        claimed = EVENT_MAX_THREAD_QUEUES;
+    }
+
+    for (u32 q = 0; q < claimed; ++q)
+    {
+        thread_event_queue *queue = &state.thread_queues[q];
+        u32 head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        u32 tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+        while (head != tail && state.queue_count < EVENT_QUEUE_CAPACITY)
+        {
+            const queued_event *e = &queue->events[head & EVENT_THREAD_QUEUE_MASK];
+            head++;
+
+            if (!event_trace_capture(e->code, e->sender, e->context, 0, true))
+            {
+                continue;
+            }
+
+            if (!try_coalesce(e->code, e->sender, e->context))
+            {
+                queue_push(e->code, e->sender, e->context);
+            }
+        }
+
+        // Hand the slots back to the producer.
+        atomic_store_explicit(&queue->head, head, memory_order_release);
+    }
+
+    u32 dropped = atomic_exchange_explicit(&state.thread_posts_dropped, 0, memory_order_relaxed);
+    if (dropped)
+    {
+        RCWARN("event_post - %u events from worker threads were dropped (thread queue full or too many posting threads).", dropped);
+    }
+}
+
+void event_dispatch_queued()
+{
+    if (is_initialized == false)
+    {
+        return;
+    }
+
+    drain_thread_queues();
+
+    // Everything about to be delivered references the active arena. Posts made from here on use the other one.
+    state.active_payload_arena ^= 1;
+    linear_allocator_free_all(&state.payload_arenas[state.active_payload_arena]);
+    state.payload_overflow_warned = false;
+
+    dispatch_begin();
+
+    // Only events queued before this call are dispatched. Anything listeners post goes to the next call.
+    u32 remaining = state.queue_count;
+    state.coalesce_floor = state.queue_head + remaining;
+    while (remaining > 0)
+    {
+        u32 start = state.queue_head;
+        u16 code = state.queue[start & EVENT_QUEUE_MASK].code;
+
+        // Batch the run of consecutive events sharing this code. Runs keep the posted order intact across codes.
+        u32 run_length = 1;
+        while (run_length < remaining && state.queue[(start + run_length) & EVENT_QUEUE_MASK].code == code)
+        {
+            run_length++;
+        }
+
+        // A snapshot; stays valid even if a callback changes the listeners for this code.
+        const event_code_entry *entry = entry_find(code);
+        if (entry != 0 && entry->listener_count != 0)
+        {
+            const registered_event *listeners = state.pool->listeners + entry->first_listener;
+            u32 listener_count = entry->listener_count;
+
+            u64 handled[EVENT_QUEUE_CAPACITY / 64];
+            rczero_memory(handled, sizeof(u64) * ((run_length + 63) / 64));
+
+            // Walk the listener list once per run, delivering every event in the run to each listener in turn.
+            for (u32 l = 0; l < listener_count; ++l)
+            {
+                registered_event listener = listeners[l];
+                for (u32 i = 0; i < run_length; ++i)
+                {
+                    u64 bit = 1ull << (i & 63);
+                    if (handled[i >> 6] & bit)
+                    {
+                        continue;
+                    }
+
+                    queued_event *e = &state.queue[(start + i) & EVENT_QUEUE_MASK];
+                    if (listener.callback(code, e->sender, listener.listener, e->context))
+                    {
+                        // Same as event_fire, a handled event is not passed on to later listeners.
+                        handled[i >> 6] |= bit;
+                    }
+                }
+            }
+        }
+
+        // Release the slots only after the run is delivered, so posts made by listeners cannot overwrite it.
+        state.queue_head = start + run_length;
+        state.queue_count -= run_length;
+        remaining -= run_length;
+    }
+
+    dispatch_end();
+
+    state.queue_overflow_warned = false;
+}
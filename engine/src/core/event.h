@@ -21,14 +21,56 @@ typedef struct event_context
         u8 u8[16];
 
         char c[16];
+
+        // Set by event_post_payload. The bytes stay valid until the dispatch that delivers the event returns.
+        struct
+        {
+            const void *data;
+            u64 size;
+        } payload;
     } data;
 } event_context;
 
 // Should return true if handled.
 typedef b8 (*PFN_on_event)(u16 code, void *sender, void *listener_inst, event_context data);
 
-b8 event_initialize();
-void event_shutdown();
+/**
+ * Folds an incoming event into one already waiting in the queue.
+ * @param code The event code of both events.
+ * @param pending The queued event's data, updated in place.
+ * @param incoming The newly posted event's data.
+ */
+typedef void (*PFN_event_merge)(u16 code, event_context *pending, event_context incoming);
+
+/**
+ * How event_post treats an event whose code already has one waiting in the
+ * queue. Coalescing never merges across a queued event of a code that does not
+ * coalesce, so e.g. a mouse move before and after a button press stay apart.
+ */
+typedef enum event_coalesce_policy
+{
+    /* Every posted event is delivered. The default for all codes. */
+    EVENT_COALESCE_NONE = 0,
+    /* The waiting event takes the newer event's sender and data. */
+    EVENT_COALESCE_LATEST,
+    /* The merge callback folds the newer event into the waiting one. */
+    EVENT_COALESCE_MERGE
+} event_coalesce_policy;
+
+/**
+ * Threading: the thread that calls event_initialize is the main thread. Only it
+ * may register, unregister, fire and dispatch. event_post may be called from
+ * any thread without locking.
+ *
+ * Listener lists are copy-on-write snapshots: registering or unregistering from
+ * inside a callback is safe and takes effect from the next event delivered.
+ */
+RCAPI b8 event_initialize();
+
+/**
+ * Shuts the event system down. Worker threads must have stopped posting first.
+ */
+RCAPI void event_shutdown();
 
 /**
  * Registers a listener for when events are sent with the provided code.
@@ -39,6 +81,18 @@ void event_shutdown();
  */
 RCAPI b8 event_register(u16 code, void *listener, PFN_on_event on_event);
 
+/**
+ * Registers a listener with a priority. Listeners are invoked from highest to
+ * lowest priority; equal priorities run in registration order. event_register
+ * uses priority 0.
+ * @param code The event code to listen for.
+ * @param listener A pointer to a listener instance. Can be 0 / NULL.
+ * @param on_event The callback function pointer to be invoked when the event code is fired.
+ * @param priority Higher values are called first and get the first chance to handle the event.
+ * @returns true if the event is successfully registered; otherwise it returns false.
+ */
+RCAPI b8 event_register_priority(u16 code, void *listener, PFN_on_event on_event, i32 priority);
+
 /**
  * Unregister from listening to events with provided code.
  * @param code The event code to stop listening for.
@@ -48,6 +102,18 @@ RCAPI b8 event_register(u16 code, void *listener, PFN_on_event on_event);
  */
 RCAPI b8 event_unregister(u16 code, void *listener, PFN_on_event on_event);
 
+/**
+ * Sets how queued events with the provided code are coalesced. Only affects
+ * event_post; event_fire always delivers. By default EVENT_CODE_MOUSE_MOVED and
+ * EVENT_CODE_RESIZED keep the latest event and EVENT_CODE_MOUSE_WHEEL sums its
+ * deltas. Main thread only.
+ * @param code The event code to configure.
+ * @param policy The coalescing policy.
+ * @param merge The merge callback. Required for EVENT_COALESCE_MERGE, ignored otherwise.
+ * @returns true on success; false if the system is not initialized or merge is missing.
+ */
+RCAPI b8 event_set_coalesce_policy(u16 code, event_coalesce_policy policy, PFN_event_merge merge);
+
 /**
  * Fires an event to listeners of the provided code.
  * @param code The event code to fire
@@ -57,6 +123,46 @@ RCAPI b8 event_unregister(u16 code, void *listener, PFN_on_event on_event);
  */
 RCAPI b8 event_fire(u16 code, void *sender, event_context context);
 
+/**
+ * Queues an event for deferred dispatch by event_dispatch_queued, which the
+ * application calls once per frame. Consecutive events with the same code are
+ * delivered as a batch: each listener receives every event of the batch before
+ * the next listener does. Codes with a coalescing policy merge into their
+ * waiting event instead of queueing another.
+ *
+ * Safe to call from any thread. On the main thread a full queue falls back to
+ * firing immediately. Other threads write to their own lock-free queue, which
+ * the main thread drains at dispatch; if it is full the event is dropped.
+ * @param code The event code to post.
+ * @param sender A pointer to the sender. Can be NULL. Must stay valid until dispatch.
+ * @param context The event data.
+ * @returns true if the event was queued or delivered; false if it was dropped.
+ */
+RCAPI b8 event_post(u16 code, void *sender, event_context context);
+
+/**
+ * Queues an event whose data does not fit in an event_context. The bytes are
+ * copied into a per-frame arena owned by the event system, and listeners read
+ * them through context.data.payload; they must not keep the pointer past their
+ * callback. Events up to 16 bytes should keep using event_post.
+ *
+ * Main thread only. If the frame's arena is full the event is fired
+ * immediately instead, still pointing at the caller's data.
+ * @param code The event code to post.
+ * @param sender A pointer to the sender. Can be NULL. Must stay valid until dispatch.
+ * @param data The payload to copy.
+ * @param size The payload size in bytes.
+ * @returns true if the event was queued or delivered; false if called off the main thread.
+ */
+RCAPI b8 event_post_payload(u16 code, void *sender, const void *data, u64 size);
+
+/**
+ * Drains worker thread queues, then dispatches every event posted before this
+ * call. Events posted by listeners during dispatch are delivered on the
+ * following call. Main thread only.
+ */
+RCAPI void event_dispatch_queued();
+
 // System internal event codes. Application should use codes beyond 255
 typedef enum system_event_code
 {
@@ -97,7 +203,7 @@ typedef enum system_event_code
 
     /**
      * Context usage:
-     * u8 z_delta = data.data.u8[0]
+     * i8 z_delta = data.data.i8[0]
      */
     EVENT_CODE_MOUSE_WHEEL = 0x07,
 
@@ -108,5 +214,11 @@ typedef enum system_event_code
      */
     EVENT_CODE_RESIZED = 0x08,
 
+    /**
+     * Context usage:
+     * b8 focused = data.data.u8[0]
+     */
+    EVENT_CODE_FOCUS_CHANGED = 0x09,
+
     MAX_EVENT_CODE = 0xFF
 } system_event_code;
\ No newline at end of file
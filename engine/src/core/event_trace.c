@@ -0,0 +1,324 @@
+#include "core/event_trace.h"
+
+#include "core/rcmemory.h"
+#include "core/logger.h"
+#include "platform/filesystem.h"
+
+#define EVENT_TRACE_MAGIC 0x54454352 // "RCET"
+#define EVENT_TRACE_VERSION 2
+#define EVENT_TRACE_MAX_SENDERS 256
+
+#define EVENT_TRACE_FLAG_POSTED 0x1
+// The record is followed by context.data.payload.size bytes of payload.
+#define EVENT_TRACE_FLAG_PAYLOAD 0x2
+
+typedef struct event_trace_header
+{
+    u32 magic;
+    u16 version;
+    u16 record_size;
+} event_trace_header;
+
+/**
+ * One captured event. Files are a header followed by these in capture order,
+ * each directly followed by its payload bytes if it has one.
+ */
+typedef struct event_trace_record
+{
+    u32 frame;
+    u16 code;
+    u8 sender_id;
+    u8 flags;
+    event_context context;
+} event_trace_record;
+
+STATIC_ASSERT(sizeof(event_trace_header) == 8, "event_trace_header must be 8 bytes.");
+STATIC_ASSERT(sizeof(event_trace_record) == 24, "event_trace_record must be 24 bytes.");
+
+typedef struct event_trace_state
+{
+    // Indexed by sender id. 0 and EVENT_TRACE_SENDER_UNKNOWN are never set.
+    void *senders[EVENT_TRACE_MAX_SENDERS];
+    u32 frame;
+
+    b8 recording;
+    file_handle file;
+    u64 recorded_count;
+
+    b8 replaying;
+    b8 injecting;
+    b8 quit_when_done;
+    // The whole trace file minus its header, and the read offset into it.
+    u8 *stream;
+    u64 stream_size;
+    u64 cursor;
+    u64 replay_count;
+} event_trace_state;
+
+static event_trace_state state;
+
+static u8 sender_to_id(void *sender)
+{
+    if (sender == 0)
+    {
+        return EVENT_TRACE_SENDER_NONE;
+    }
+
+    for (u32 i = 1; i < EVENT_TRACE_SENDER_UNKNOWN; ++i)
+    {
+        if (state.senders[i] == sender)
+        {
+            return (u8)i;
+        }
+    }
+    return EVENT_TRACE_SENDER_UNKNOWN;
+}
+
+b8 event_trace_register_sender(void *sender, u8 id)
+{
+    if (id == EVENT_TRACE_SENDER_NONE || id == EVENT_TRACE_SENDER_UNKNOWN)
+    {
+        RCERROR("event_trace_register_sender - id %u is reserved.", id);
+        return false;
+    }
+
+    state.senders[id] = sender;
+    return true;
+}
+
+b8 event_trace_record_begin(const char *path)
+{
+    if (state.recording || state.replaying)
+    {
+        RCERROR("event_trace_record_begin - a recording or replay is already running.");
+        return false;
+    }
+
+    if (!filesystem_open(path, FILE_MODE_WRITE, true, &state.file))
+    {
+        return false;
+    }
+
+    event_trace_header header = {EVENT_TRACE_MAGIC, EVENT_TRACE_VERSION, sizeof(event_trace_record)};
+    u64 written = 0;
+    if (!filesystem_write(&state.file, sizeof(header), &header, &written))
+    {
+        RCERROR("event_trace_record_begin - failed to write header to '%s'.", path);
+        filesystem_close(&state.file);
+        return false;
+    }
+
+    state.frame = 0;
+    state.recorded_count = 0;
+    state.recording = true;
+    RCINFO("Recording events to '%s'.", path);
+    return true;
+}
+
+b8 event_trace_record_end()
+{
+    if (!state.recording)
+    {
+        return false;
+    }
+
+    filesystem_close(&state.file);
+    state.recording = false;
+    RCINFO("Event recording stopped: %llu events over %u frames.", state.recorded_count, state.frame);
+    return true;
+}
+
+b8 event_trace_replay_begin(const char *path, b8 quit_when_done)
+{
+    if (state.recording || state.replaying)
+    {
+        RCERROR("event_trace_replay_begin - a recording or replay is already running.");
+        return false;
+    }
+
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_READ, true, &file))
+    {
+        return false;
+    }
+
+    u64 size = 0;
+    u64 read = 0;
+    event_trace_header header;
+    if (!filesystem_size(&file, &size) || size < sizeof(header) || !filesystem_read(&file, sizeof(header), &header, &read))
+    {
+        RCERROR("event_trace_replay_begin - '%s' is not an event trace.", path);
+        filesystem_close(&file);
+        return false;
+    }
+
+    if (header.magic != EVENT_TRACE_MAGIC || header.version != EVENT_TRACE_VERSION || header.record_size != sizeof(event_trace_record))
+    {
+        RCERROR("event_trace_replay_begin - '%s' is not a version %u event trace.", path, EVENT_TRACE_VERSION);
+        filesystem_close(&file);
+        return false;
+    }
+
+    u64 stream_size = size - sizeof(header);
+    u8 *stream = 0;
+    if (stream_size)
+    {
+        stream = rcallocate(stream_size, MEMORY_TAG_ARRAY);
+        if (!filesystem_read(&file, stream_size, stream, &read))
+        {
+            RCERROR("event_trace_replay_begin - failed to read '%s'.", path);
+            rcfree(stream, stream_size, MEMORY_TAG_ARRAY);
+            filesystem_close(&file);
+            return false;
+        }
+    }
+    filesystem_close(&file);
+
+    state.stream = stream;
+    state.stream_size = stream_size;
+    state.cursor = 0;
+    state.replay_count = 0;
+    state.frame = 0;
+    state.quit_when_done = quit_when_done;
+    state.replaying = true;
+    RCINFO("Replaying %llu bytes of events from '%s'.", stream_size, path);
+    return true;
+}
+
+void event_trace_replay_end()
+{
+    if (!state.replaying)
+    {
+        return;
+    }
+
+    if (state.stream)
+    {
+        rcfree(state.stream, state.stream_size, MEMORY_TAG_ARRAY);
+        state.stream = 0;
+    }
+    state.stream_size = 0;
+    state.cursor = 0;
+    state.replaying = false;
+}
+
+b8 event_trace_is_recording()
+{
+    return state.recording;
+}
+
+b8 event_trace_is_replaying()
+{
+    return state.replaying;
+}
+
+void event_trace_frame_begin()
+{
+    state.frame++;
+    if (!state.replaying)
+    {
+        return;
+    }
+
+    state.injecting = true;
+    b8 finished = false;
+    for (;;)
+    {
+        event_trace_record record;
+        // A trace cut short by a crash may end in a partial record; stop there.
+        if (state.cursor + sizeof(record) > state.stream_size)
+        {
+            finished = true;
+            break;
+        }
+
+        // Records are not aligned in the stream once payloads are involved.
+        rccopy_memory(&record, state.stream + state.cursor, sizeof(record));
+        if (record.frame > state.frame)
+        {
+            break;
+        }
+
+        const u8 *payload = state.stream + state.cursor + sizeof(record);
+        u64 payload_size = (record.flags & EVENT_TRACE_FLAG_PAYLOAD) ? record.context.data.payload.size : 0;
+        if (state.cursor + sizeof(record) + payload_size > state.stream_size)
+        {
+            finished = true;
+            break;
+        }
+        state.cursor += sizeof(record) + payload_size;
+        state.replay_count++;
+
+        void *sender = state.senders[record.sender_id];
+        if (record.flags & EVENT_TRACE_FLAG_PAYLOAD)
+        {
+            event_post_payload(record.code, sender, payload, payload_size);
+        }
+        else if (record.flags & EVENT_TRACE_FLAG_POSTED)
+        {
+            event_post(record.code, sender, record.context);
+        }
+        else
+        {
+            event_fire(record.code, sender, record.context);
+        }
+    }
+    state.injecting = false;
+
+    if (finished)
+    {
+        RCINFO("Event replay finished: %llu events over %u frames.", state.replay_count, state.frame);
+        b8 quit = state.quit_when_done;
+        event_trace_replay_end();
+        if (quit)
+        {
+            event_context context = {0};
+            event_post(EVENT_CODE_APPLICATION_QUIT, 0, context);
+        }
+    }
+}
+
+b8 event_trace_capture(u16 code, void *sender, event_context context, const void *payload, b8 posted)
+{
+    if (state.replaying)
+    {
+        return state.injecting || code == EVENT_CODE_APPLICATION_QUIT;
+    }
+
+    if (state.recording)
+    {
+        event_trace_record record;
+        record.frame = state.frame;
+        record.code = code;
+        record.sender_id = sender_to_id(sender);
+        record.flags = posted ? EVENT_TRACE_FLAG_POSTED : 0;
+        record.context = context;
+
+        u64 payload_size = 0;
+        if (payload)
+        {
+            // The pointer means nothing in another run; the bytes follow the record instead.
+            record.flags |= EVENT_TRACE_FLAG_PAYLOAD;
+            payload_size = context.data.payload.size;
+            record.context.data.payload.data = 0;
+        }
+
+        u64 written = 0;
+        if (!filesystem_write(&state.file, sizeof(record), &record, &written) ||
+            (payload_size && !filesystem_write(&state.file, payload_size, payload, &written)))
+        {
+            RCERROR("event_trace_capture - write failed, recording stopped.");
+            event_trace_record_end();
+            return true;
+        }
+        state.recorded_count++;
+    }
+
+    return true;
+}
+
+void event_trace_shutdown()
+{
+    event_trace_record_end();
+    event_trace_replay_end();
+}
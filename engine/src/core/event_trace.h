@@ -0,0 +1,89 @@
+#pragma once
+
+#include "defines.h"
+#include "core/event.h"
+
+/**
+ * Records the events that enter the event system to a compact binary file and
+ * plays them back at the same frame boundaries, so an input session can be
+ * reproduced exactly without anyone at the keyboard.
+ *
+ * Only events raised outside a dispatch are captured: those from the platform
+ * layer, input, worker threads and direct calls from frame code. Events that
+ * listeners raise in response are not, since replaying the cause recreates
+ * them. Posted events are captured before coalescing and replayed through
+ * event_post, so they coalesce the same way again. Payloads posted with
+ * event_post_payload are stored in the trace by value.
+ *
+ * While replaying, events from live sources are discarded, except
+ * EVENT_CODE_APPLICATION_QUIT so the window can still be closed. Input state
+ * polled through input.h is not part of the trace.
+ *
+ * Main thread only.
+ */
+
+// Sender id recorded for a null sender.
+#define EVENT_TRACE_SENDER_NONE 0
+// Sender id recorded for a sender that was never registered; replayed as null.
+#define EVENT_TRACE_SENDER_UNKNOWN 0xFF
+
+/**
+ * Gives a sender a stable id, so its events can be replayed with the right
+ * sender pointer in a later run. Register the same ids before recording and
+ * before replaying.
+ * @param sender The sender pointer.
+ * @param id The id, 1 to 254.
+ * @returns true on success; false if the id is out of range.
+ */
+RCAPI b8 event_trace_register_sender(void *sender, u8 id);
+
+/**
+ * Starts recording to the provided file, replacing its contents. Events raised
+ * before the first event_trace_frame_begin belong to frame 0.
+ * @param path The file to write.
+ * @returns true if recording started; false if already recording or replaying, or the file could not be opened.
+ */
+RCAPI b8 event_trace_record_begin(const char *path);
+
+/**
+ * Stops recording and closes the file.
+ * @returns true if a recording was in progress; otherwise false.
+ */
+RCAPI b8 event_trace_record_end();
+
+/**
+ * Loads a trace and starts replaying it. Events from frame 0 are delivered
+ * with those of frame 1.
+ * @param path The file to read.
+ * @param quit_when_done If true, EVENT_CODE_APPLICATION_QUIT is posted once the trace runs out, and delivered at the next event_dispatch_queued.
+ * @returns true if replay started; false if already recording or replaying, or the file is missing or invalid.
+ */
+RCAPI b8 event_trace_replay_begin(const char *path, b8 quit_when_done);
+
+/**
+ * Stops replaying and returns to live input.
+ */
+RCAPI void event_trace_replay_end();
+
+RCAPI b8 event_trace_is_recording();
+RCAPI b8 event_trace_is_replaying();
+
+/**
+ * Marks the start of a frame. The application calls this once per frame,
+ * before pumping platform messages. When replaying, this is where the frame's
+ * recorded events are raised.
+ */
+void event_trace_frame_begin();
+
+/**
+ * Called by the event system for each event raised outside a dispatch.
+ * Records it if recording.
+ * @param payload For events posted with event_post_payload, the payload bytes; otherwise 0.
+ * @returns false if the event must be discarded because a replay is running.
+ */
+b8 event_trace_capture(u16 code, void *sender, event_context context, const void *payload, b8 posted);
+
+/**
+ * Ends any recording or replay. Called by event_shutdown.
+ */
+void event_trace_shutdown();
@@ -0,0 +1,62 @@
+#include "core/fixed_timestep.h"
+#include "core/clock.h"
+#include "core/rcmemory.h"
+#include "platform/platform.h"
+
+void fixed_timestep_init(fixed_timestep *timestep, f64 rate, u32 max_steps)
+{
+    rczero_memory(timestep, sizeof(fixed_timestep));
+    timestep->step_ns = rate > 0 ? clock_seconds_to_ns(1.0 / rate) : RC_NS_PER_SECOND / 60;
+    timestep->max_steps = max_steps ? max_steps : FIXED_TIMESTEP_DEFAULT_MAX_STEPS;
+}
+
+void fixed_timestep_begin_frame(fixed_timestep *timestep, u64 frame_ns)
+{
+    timestep->accumulator_ns += frame_ns;
+    timestep->steps_this_frame = 0;
+    timestep->frame_start_ns = platform_get_time_ns();
+}
+
+b8 fixed_timestep_step(fixed_timestep *timestep)
+{
+    b8 due = timestep->accumulator_ns >= timestep->step_ns;
+    if (due && timestep->steps_this_frame < timestep->max_steps)
+    {
+        timestep->accumulator_ns -= timestep->step_ns;
+        timestep->steps_this_frame++;
+        timestep->stats.total_steps++;
+        return true;
+    }
+
+    fixed_timestep_stats *stats = &timestep->stats;
+    if (due)
+    {
+        // Out of steps for this frame. Drop the backlog rather than carrying a debt that only grows,
+        // but keep the fraction so alpha stays continuous.
+        stats->dropped_steps += timestep->accumulator_ns / timestep->step_ns;
+        timestep->accumulator_ns %= timestep->step_ns;
+    }
+
+    u64 update_ns = platform_get_time_ns() - timestep->frame_start_ns;
+    stats->last_steps = timestep->steps_this_frame;
+    stats->last_update_ns = update_ns;
+    if (update_ns > stats->max_update_ns)
+    {
+        stats->max_update_ns = update_ns;
+    }
+    if (timestep->steps_this_frame > 1)
+    {
+        stats->catch_up_frames++;
+    }
+    return false;
+}
+
+f32 fixed_timestep_alpha(const fixed_timestep *timestep)
+{
+    return (f32)((f64)timestep->accumulator_ns / (f64)timestep->step_ns);
+}
+
+f32 fixed_timestep_step_seconds(const fixed_timestep *timestep)
+{
+    return (f32)clock_ns_to_seconds(timestep->step_ns);
+}
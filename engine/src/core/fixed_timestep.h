@@ -0,0 +1,81 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * Runs the simulation in steps of a fixed length, independent of the frame
+ * rate. Frame time goes into an accumulator and is paid out in whole steps;
+ * what is left over becomes the interpolation alpha for rendering between
+ * the last two simulated states. Time is kept in integer nanoseconds, so the
+ * step sequence is deterministic.
+ *
+ * Usage per frame:
+ *   fixed_timestep_begin_frame(&ts, frame_ns);
+ *   while (fixed_timestep_step(&ts)) { update(step); }
+ *   render(fixed_timestep_alpha(&ts));
+ */
+
+// Steps one frame may run when no limit is given. Keeps a slow frame from owing more steps than it can run.
+#define FIXED_TIMESTEP_DEFAULT_MAX_STEPS 8
+// Pass as max_steps to let a frame run every step it owes. Can spiral when steps are slower than real time.
+#define FIXED_TIMESTEP_UNLIMITED_STEPS 0xFFFFFFFFu
+
+typedef struct fixed_timestep_stats
+{
+    u64 total_steps;
+    // Steps run in the last frame.
+    u32 last_steps;
+    // Frames that needed more than one step to catch up.
+    u64 catch_up_frames;
+    // Steps skipped because a frame hit max_steps; the simulation fell behind real time by this many.
+    u64 dropped_steps;
+    // Wall time spent running the last frame's steps.
+    u64 last_update_ns;
+    u64 max_update_ns;
+} fixed_timestep_stats;
+
+typedef struct fixed_timestep
+{
+    u64 step_ns;
+    u32 max_steps;
+    u64 accumulator_ns;
+
+    // Per frame.
+    u32 steps_this_frame;
+    u64 frame_start_ns;
+
+    fixed_timestep_stats stats;
+} fixed_timestep;
+
+/**
+ * Resets the timestep and its stats.
+ * @param timestep The timestep to initialize.
+ * @param rate Steps per second.
+ * @param max_steps The most steps one frame may run; a frame owing more drops the excess.
+ * 0 for FIXED_TIMESTEP_DEFAULT_MAX_STEPS, or FIXED_TIMESTEP_UNLIMITED_STEPS for no limit.
+ */
+RCAPI void fixed_timestep_init(fixed_timestep *timestep, f64 rate, u32 max_steps);
+
+/**
+ * Adds a frame's elapsed time to the accumulator. Call once per frame, before stepping.
+ * @param timestep The timestep.
+ * @param frame_ns Time since the previous frame in nanoseconds.
+ */
+RCAPI void fixed_timestep_begin_frame(fixed_timestep *timestep, u64 frame_ns);
+
+/**
+ * Takes the next step from the accumulator, if one is due.
+ * @param timestep The timestep.
+ * @returns true if a step should be run now; false when the frame's steps are done.
+ */
+RCAPI b8 fixed_timestep_step(fixed_timestep *timestep);
+
+/**
+ * @returns How far the current time is between the last step and the next, from 0 to 1.
+ */
+RCAPI f32 fixed_timestep_alpha(const fixed_timestep *timestep);
+
+/**
+ * @returns The step length in seconds.
+ */
+RCAPI f32 fixed_timestep_step_seconds(const fixed_timestep *timestep);
@@ -0,0 +1,107 @@
+#include "core/frame_pacer.h"
+#include "core/clock.h"
+#include "core/rcmemory.h"
+#include "math/rcmath.h"
+#include "platform/platform.h"
+
+// Assumed length of a 1 ms sleep until measurements come in. Deliberately pessimistic.
+#define INITIAL_SLEEP_ESTIMATE_NS 2000000.0
+// Older sleep measurements are decayed past this count so the estimate follows changes in timer resolution.
+#define MAX_SLEEP_SAMPLES 256
+
+void frame_pacer_init(frame_pacer *pacer, f64 target_rate)
+{
+    rczero_memory(pacer, sizeof(frame_pacer));
+    pacer->sleep_mean_ns = INITIAL_SLEEP_ESTIMATE_NS;
+    pacer->sleep_samples = 1;
+    frame_pacer_set_target_rate(pacer, target_rate);
+}
+
+void frame_pacer_set_target_rate(frame_pacer *pacer, f64 target_rate)
+{
+    pacer->target_frame_ns = target_rate > 0 ? clock_seconds_to_ns(1.0 / target_rate) : 0;
+    pacer->deadline_ns = 0;
+}
+
+static void record_sleep(frame_pacer *pacer, u64 observed_ns)
+{
+    if (pacer->sleep_samples >= MAX_SLEEP_SAMPLES)
+    {
+        pacer->sleep_samples /= 2;
+        pacer->sleep_m2 /= 2;
+    }
+
+    // Welford's online mean and variance.
+    pacer->sleep_samples++;
+    f64 delta = (f64)observed_ns - pacer->sleep_mean_ns;
+    pacer->sleep_mean_ns += delta / (f64)pacer->sleep_samples;
+    pacer->sleep_m2 += delta * ((f64)observed_ns - pacer->sleep_mean_ns);
+}
+
+static u64 sleep_margin_ns(const frame_pacer *pacer)
+{
+    // Mean plus two standard deviations of a 1 ms sleep.
+    f64 variance = pacer->sleep_samples > 1 ? pacer->sleep_m2 / (f64)(pacer->sleep_samples - 1) : 0;
+    return (u64)(pacer->sleep_mean_ns + 2.0 * rcsqrt((f32)variance));
+}
+
+void frame_pacer_wait(frame_pacer *pacer)
+{
+    frame_pacer_stats *stats = &pacer->stats;
+    u64 now = platform_get_time_ns();
+    u64 wait_start = now;
+
+    if (pacer->target_frame_ns == 0)
+    {
+        stats->frame_count++;
+        stats->last_lateness_ns = 0;
+        stats->last_wait_ns = 0;
+        return;
+    }
+
+    if (pacer->deadline_ns == 0)
+    {
+        // First frame after a (re)start: pace from here.
+        pacer->deadline_ns = now + pacer->target_frame_ns;
+    }
+
+    u64 deadline = pacer->deadline_ns;
+    if (now < deadline)
+    {
+        // Coarse: sleep while the deadline is further away than a sleep can overshoot.
+        while (deadline - now > sleep_margin_ns(pacer))
+        {
+            platform_sleep(1);
+            u64 woke = platform_get_time_ns();
+            record_sleep(pacer, woke - now);
+            now = woke;
+            if (now >= deadline)
+            {
+                break;
+            }
+        }
+
+        // Fine: spin out the rest.
+        while (now < deadline)
+        {
+            now = platform_get_time_ns();
+        }
+    }
+
+    u64 lateness = now - deadline;
+    stats->frame_count++;
+    stats->last_lateness_ns = lateness;
+    stats->last_wait_ns = now - wait_start;
+    if (lateness > stats->max_lateness_ns)
+    {
+        stats->max_lateness_ns = lateness;
+    }
+    if (lateness > FRAME_PACER_LATE_TOLERANCE_NS)
+    {
+        stats->late_frames++;
+    }
+    stats->average_lateness_ns += ((f64)lateness - stats->average_lateness_ns) / (f64)stats->frame_count;
+
+    // Keep a fixed cadence, unless this frame overran a whole period; then restart from now instead of rushing to catch up.
+    pacer->deadline_ns = lateness < pacer->target_frame_ns ? deadline + pacer->target_frame_ns : now + pacer->target_frame_ns;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * Holds frames to a target rate. The wait sleeps in 1 ms steps while the
+ * deadline is further away than a sleep can overshoot, then spins on the
+ * monotonic clock for the rest, so frames end within tens of microseconds
+ * of the deadline without burning a core for the whole frame.
+ */
+
+typedef struct frame_pacer_stats
+{
+    u64 frame_count;
+    // Frames that ended more than FRAME_PACER_LATE_TOLERANCE_NS past their deadline.
+    u64 late_frames;
+    // How far past its deadline the last frame ended. Includes frames that overran the target.
+    u64 last_lateness_ns;
+    u64 max_lateness_ns;
+    f64 average_lateness_ns;
+    // Time spent waiting in the last frame.
+    u64 last_wait_ns;
+} frame_pacer_stats;
+
+typedef struct frame_pacer
+{
+    // 0 when uncapped.
+    u64 target_frame_ns;
+    u64 deadline_ns;
+
+    // Running estimate of how long platform_sleep(1) really takes, as a mean and variance.
+    f64 sleep_mean_ns;
+    f64 sleep_m2;
+    u64 sleep_samples;
+
+    frame_pacer_stats stats;
+} frame_pacer;
+
+// Lateness under this is treated as on time.
+#define FRAME_PACER_LATE_TOLERANCE_NS 50000ull
+
+/**
+ * Resets the pacer and its stats.
+ * @param pacer The pacer to initialize.
+ * @param target_rate Frames per second to hold to; 0 for uncapped.
+ */
+RCAPI void frame_pacer_init(frame_pacer *pacer, f64 target_rate);
+
+/**
+ * Changes the target rate. Takes effect from the next frame.
+ * @param pacer The pacer.
+ * @param target_rate Frames per second to hold to; 0 for uncapped.
+ */
+RCAPI void frame_pacer_set_target_rate(frame_pacer *pacer, f64 target_rate);
+
+/**
+ * Waits until the current frame's deadline and records how late it ended.
+ * Call once at the end of each frame. A frame that already overran its
+ * deadline does not wait, and the next deadline is counted from now rather
+ * than trying to catch up.
+ * @param pacer The pacer.
+ */
+RCAPI void frame_pacer_wait(frame_pacer *pacer);
@@ -0,0 +1,229 @@
+#include "core/frame_stats.h"
+#include "core/clock.h"
+#include "core/logger.h"
+#include "core/rcmemory.h"
+#include "core/rcstring.h"
+
+void frame_stats_init(frame_stats *stats, f64 hitch_threshold_ms)
+{
+    rczero_memory(stats, sizeof(frame_stats));
+    stats->hitch_threshold_ns = hitch_threshold_ms > 0 ? (u64)(hitch_threshold_ms * RC_NS_PER_MS) : 0;
+}
+
+static void sort_u64(u64 *values, u32 count)
+{
+    // Shell sort with Ciura's gaps; the window is small enough that this beats a quicksort's bookkeeping.
+    static const u32 gaps[] = {701, 301, 132, 57, 23, 10, 4, 1};
+    for (u32 g = 0; g < sizeof(gaps) / sizeof(gaps[0]); ++g)
+    {
+        u32 gap = gaps[g];
+        for (u32 i = gap; i < count; ++i)
+        {
+            u64 value = values[i];
+            u32 j = i;
+            for (; j >= gap && values[j - gap] > value; j -= gap)
+            {
+                values[j] = values[j - gap];
+            }
+            values[j] = value;
+        }
+    }
+}
+
+// Nearest-rank percentile of sorted values.
+static u64 percentile(const u64 *sorted, u32 count, u32 percent)
+{
+    u32 rank = (u32)(((u64)count * percent + 99) / 100);
+    return sorted[rank ? rank - 1 : 0];
+}
+
+static void series_add(frame_stats_series *series, u64 value)
+{
+    if (series->count == FRAME_STATS_WINDOW)
+    {
+        series->total_ns -= series->values[series->next];
+    }
+    else
+    {
+        series->count++;
+    }
+    series->values[series->next] = value;
+    series->next = (series->next + 1) % FRAME_STATS_WINDOW;
+    series->total_ns += value;
+}
+
+static void series_summarize(const frame_stats_series *series, u64 *scratch, frame_stats_distribution *out_distribution)
+{
+    rczero_memory(out_distribution, sizeof(frame_stats_distribution));
+
+    u32 count = series->count;
+    if (count == 0)
+    {
+        return;
+    }
+
+    rccopy_memory(scratch, series->values, sizeof(u64) * count);
+    sort_u64(scratch, count);
+
+    out_distribution->sample_count = count;
+    out_distribution->min_ns = scratch[0];
+    out_distribution->max_ns = scratch[count - 1];
+    out_distribution->average_ns = (f64)series->total_ns / (f64)count;
+    out_distribution->p50_ns = percentile(scratch, count, 50);
+    out_distribution->p95_ns = percentile(scratch, count, 95);
+    out_distribution->p99_ns = percentile(scratch, count, 99);
+}
+
+// The latest sample of a series, or 0 if it has none.
+static u64 series_latest(const frame_stats_series *series)
+{
+    return series->count ? series->values[(series->next + FRAME_STATS_WINDOW - 1) % FRAME_STATS_WINDOW] : 0;
+}
+
+void frame_stats_summarize(frame_stats *stats, frame_stats_summary *out_summary)
+{
+    series_summarize(&stats->frame, stats->scratch, &out_summary->frame);
+    series_summarize(&stats->cpu, stats->scratch, &out_summary->cpu);
+    series_summarize(&stats->gpu, stats->scratch, &out_summary->gpu);
+    out_summary->total_frames = stats->total_frames;
+    out_summary->total_hitches = stats->total_hitches;
+}
+
+static void write_dump_row(frame_stats *stats)
+{
+    frame_stats_summary summary;
+    frame_stats_summarize(stats, &summary);
+
+    char row[512];
+    f64 time = clock_ns_to_seconds(stats->dump_elapsed_ns);
+    u64 hitches = stats->total_hitches - stats->dump_hitches_at_row;
+    u64 length = string_format(
+        row,
+        sizeof(row),
+        stats->dump_json
+            ? "{\"time\":%.3f,\"frames\":%u,\"min_ms\":%.3f,\"avg_ms\":%.3f,\"p50_ms\":%.3f,\"p95_ms\":%.3f,\"p99_ms\":%.3f,\"max_ms\":%.3f,"
+              "\"cpu_avg_ms\":%.3f,\"cpu_p99_ms\":%.3f,\"gpu_avg_ms\":%.3f,\"gpu_p99_ms\":%.3f,\"hitches\":%llu}\n"
+            : "%.3f,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%llu\n",
+        time,
+        summary.frame.sample_count,
+        clock_ns_to_ms(summary.frame.min_ns),
+        summary.frame.average_ns / RC_NS_PER_MS,
+        clock_ns_to_ms(summary.frame.p50_ns),
+        clock_ns_to_ms(summary.frame.p95_ns),
+        clock_ns_to_ms(summary.frame.p99_ns),
+        clock_ns_to_ms(summary.frame.max_ns),
+        summary.cpu.average_ns / RC_NS_PER_MS,
+        clock_ns_to_ms(summary.cpu.p99_ns),
+        summary.gpu.average_ns / RC_NS_PER_MS,
+        clock_ns_to_ms(summary.gpu.p99_ns),
+        hitches);
+    // string_format reports the untruncated length; never write past the row.
+    if (length > sizeof(row) - 1)
+    {
+        length = sizeof(row) - 1;
+    }
+
+    u64 written = 0;
+    if (!filesystem_write(&stats->dump_file, length, row, &written))
+    {
+        RCERROR("frame_stats - failed to write a dump row, stopping.");
+        frame_stats_dump_end(stats);
+        return;
+    }
+    filesystem_flush(&stats->dump_file);
+
+    stats->dump_since_row_ns = 0;
+    stats->dump_hitches_at_row = stats->total_hitches;
+}
+
+b8 frame_stats_add(frame_stats *stats, u64 frame_ns)
+{
+    // Judge against the window before this frame joins it.
+    frame_stats_series *frame = &stats->frame;
+    u64 threshold = stats->hitch_threshold_ns;
+    if (threshold == 0 && frame->count >= FRAME_STATS_HITCH_MIN_SAMPLES)
+    {
+        threshold = (u64)(FRAME_STATS_HITCH_FACTOR * (f64)frame->total_ns / (f64)frame->count);
+    }
+    b8 hitch = threshold && frame_ns > threshold;
+
+    series_add(frame, frame_ns);
+    stats->total_frames++;
+
+    if (hitch)
+    {
+        stats->total_hitches++;
+        stats->last_hitch_ns = frame_ns;
+        RCLOG_LIMITED(
+            CORE,
+            LOG_LEVEL_INFO,
+            1,
+            "Hitch: frame %llu took %.2f ms (threshold %.2f ms; latest CPU %.2f ms, GPU %.2f ms).",
+            stats->total_frames,
+            clock_ns_to_ms(frame_ns),
+            clock_ns_to_ms(threshold),
+            clock_ns_to_ms(series_latest(&stats->cpu)),
+            clock_ns_to_ms(series_latest(&stats->gpu)));
+    }
+
+    if (stats->dumping)
+    {
+        stats->dump_elapsed_ns += frame_ns;
+        stats->dump_since_row_ns += frame_ns;
+        if (stats->dump_since_row_ns >= stats->dump_interval_ns)
+        {
+            write_dump_row(stats);
+        }
+    }
+
+    return hitch;
+}
+
+void frame_stats_add_cpu_time(frame_stats *stats, u64 cpu_ns)
+{
+    series_add(&stats->cpu, cpu_ns);
+}
+
+void frame_stats_add_gpu_time(frame_stats *stats, u64 gpu_ns)
+{
+    series_add(&stats->gpu, gpu_ns);
+}
+
+b8 frame_stats_dump_begin(frame_stats *stats, const char *path, f64 interval_seconds)
+{
+    frame_stats_dump_end(stats);
+
+    if (!filesystem_open(path, FILE_MODE_WRITE, false, &stats->dump_file))
+    {
+        RCERROR("frame_stats_dump_begin - could not open '%s' for writing.", path);
+        return false;
+    }
+
+    u64 length = string_length(path);
+    stats->dump_json = length >= 5 && strings_equali(path + length - 5, ".json");
+    if (!stats->dump_json)
+    {
+        const char *header = "time,frames,min_ms,avg_ms,p50_ms,p95_ms,p99_ms,max_ms,cpu_avg_ms,cpu_p99_ms,gpu_avg_ms,gpu_p99_ms,hitches\n";
+        u64 written = 0;
+        filesystem_write(&stats->dump_file, string_length(header), header, &written);
+    }
+
+    stats->dumping = true;
+    stats->dump_interval_ns = interval_seconds > 0 ? clock_seconds_to_ns(interval_seconds) : RC_NS_PER_SECOND;
+    stats->dump_elapsed_ns = 0;
+    stats->dump_since_row_ns = 0;
+    stats->dump_hitches_at_row = stats->total_hitches;
+    RCINFO("Writing frame stats to '%s' every %.1f s.", path, clock_ns_to_seconds(stats->dump_interval_ns));
+    return true;
+}
+
+void frame_stats_dump_end(frame_stats *stats)
+{
+    if (!stats->dumping)
+    {
+        return;
+    }
+
+    stats->dumping = false;
+    filesystem_close(&stats->dump_file);
+}
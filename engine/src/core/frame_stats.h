@@ -0,0 +1,135 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/filesystem.h"
+
+/**
+ * Rolling frame time statistics. Keeps the last FRAME_STATS_WINDOW frame
+ * times, summarized on request as min/average/percentiles/max, flags
+ * hitches as they happen, and can append a summary row to a CSV or JSON
+ * Lines file at a fixed interval.
+ *
+ * The CPU time spent on each frame and the GPU time measured by the
+ * renderer can be added alongside, to tell whether slow frames are bound by
+ * one or the other.
+ */
+
+#define FRAME_STATS_WINDOW 1024
+// With no hitch threshold set, a frame is a hitch when it takes this many times the window's average.
+#define FRAME_STATS_HITCH_FACTOR 2.0
+// Relative hitches are only flagged once the window holds this many frames.
+#define FRAME_STATS_HITCH_MIN_SAMPLES 30
+
+typedef struct frame_stats_distribution
+{
+    // Samples the rest covers; at most FRAME_STATS_WINDOW.
+    u32 sample_count;
+    u64 min_ns;
+    f64 average_ns;
+    u64 p50_ns;
+    u64 p95_ns;
+    u64 p99_ns;
+    u64 max_ns;
+} frame_stats_distribution;
+
+typedef struct frame_stats_summary
+{
+    // Time from the start of one frame to the start of the next.
+    frame_stats_distribution frame;
+    // Time the CPU spent on a frame, excluding waits for the frame pacer.
+    frame_stats_distribution cpu;
+    // Time the GPU spent on a frame's commands.
+    frame_stats_distribution gpu;
+    // Over the whole run, not just the window.
+    u64 total_frames;
+    u64 total_hitches;
+} frame_stats_summary;
+
+// Ring of the last FRAME_STATS_WINDOW samples of one measurement.
+typedef struct frame_stats_series
+{
+    u64 values[FRAME_STATS_WINDOW];
+    u32 next;
+    u32 count;
+    u64 total_ns;
+} frame_stats_series;
+
+typedef struct frame_stats
+{
+    frame_stats_series frame;
+    frame_stats_series cpu;
+    frame_stats_series gpu;
+
+    u64 total_frames;
+    u64 total_hitches;
+    // 0 to judge hitches against the window's average.
+    u64 hitch_threshold_ns;
+    u64 last_hitch_ns;
+
+    // Periodic dumps.
+    file_handle dump_file;
+    b8 dumping;
+    b8 dump_json;
+    u64 dump_interval_ns;
+    u64 dump_elapsed_ns;
+    u64 dump_since_row_ns;
+    u64 dump_hitches_at_row;
+
+    // Sorting space for percentiles.
+    u64 scratch[FRAME_STATS_WINDOW];
+} frame_stats;
+
+/**
+ * Resets the stats.
+ * @param stats The stats to initialize.
+ * @param hitch_threshold_ms Frames longer than this are hitches. 0 to use FRAME_STATS_HITCH_FACTOR times the average.
+ */
+RCAPI void frame_stats_init(frame_stats *stats, f64 hitch_threshold_ms);
+
+/**
+ * Records a frame. Writes a dump row if one is due.
+ * @param stats The stats.
+ * @param frame_ns The frame's length in nanoseconds.
+ * @returns true if the frame was a hitch.
+ */
+RCAPI b8 frame_stats_add(frame_stats *stats, u64 frame_ns);
+
+/**
+ * Records the CPU time spent on a frame.
+ * @param stats The stats.
+ * @param cpu_ns The time in nanoseconds.
+ */
+RCAPI void frame_stats_add_cpu_time(frame_stats *stats, u64 cpu_ns);
+
+/**
+ * Records the GPU time spent on a frame. GPU times arrive a frame or more
+ * late, so they are not matched to frame times.
+ * @param stats The stats.
+ * @param gpu_ns The time in nanoseconds.
+ */
+RCAPI void frame_stats_add_gpu_time(frame_stats *stats, u64 gpu_ns);
+
+/**
+ * Summarizes the frames in the window. Sorts a copy of the window, so call
+ * it when the numbers are needed rather than every frame.
+ * @param stats The stats.
+ * @param out_summary Receives the summary.
+ */
+RCAPI void frame_stats_summarize(frame_stats *stats, frame_stats_summary *out_summary);
+
+/**
+ * Starts appending a summary row to a file every interval. Each row holds
+ * the window's summary at the time and the hitches since the last row. A
+ * path ending in ".json" gets JSON Lines (one object per row); anything
+ * else gets CSV.
+ * @param stats The stats.
+ * @param path The file to write. Replaced if it exists.
+ * @param interval_seconds Frame time between rows.
+ * @returns true if the file was opened.
+ */
+RCAPI b8 frame_stats_dump_begin(frame_stats *stats, const char *path, f64 interval_seconds);
+
+/**
+ * Stops dumping and closes the file.
+ */
+RCAPI void frame_stats_dump_end(frame_stats *stats);
@@ -1,18 +1,27 @@
 #include "core/input.h"
+#include "core/input_recorder.h"
+#include "core/input_actions.h"
 #include "core/event.h"
 #include "core/rcmemory.h"
 #include "core/logger.h"
+#include "math/rcmath.h"
 
+#if RCARCH_X64
+#include <emmintrin.h>
+#endif
+
+// One bit per key code, key n is bit (n % 64) of keys[n / 64].
 typedef struct keyboard_state
 {
-    b8 keys[256];
+    u64 keys[INPUT_KEY_MASK_WORDS];
 } keyboard_state;
 
 typedef struct mouse_state
 {
     i16 x;
     i16 y;
-    u8 buttons[BUTTON_MAX_BUTTONS];
+    // One bit per button.
+    u8 buttons;
 } mouse_state;
 
 typedef struct input_state
@@ -26,6 +35,35 @@ typedef struct input_state
 static b8 initialized = false;
 static input_state state = {};
 
+RCINLINE b8 key_bit(const keyboard_state *keyboard, keys key)
+{
+    return (keyboard->keys[(u32)key >> 6] >> ((u32)key & 63)) & 1;
+}
+
+RCINLINE b8 button_bit(const mouse_state *mouse, buttons button)
+{
+    return (mouse->buttons >> button) & 1;
+}
+
+/**
+ * out = a & ~b over all 256 bits: keys set in a that are not set in b.
+ */
+static void key_mask_and_not(const keyboard_state *a, const keyboard_state *b, input_key_mask *out_mask)
+{
+#if RCARCH_X64
+    const __m128i *va = (const __m128i *)a->keys;
+    const __m128i *vb = (const __m128i *)b->keys;
+    __m128i *vout = (__m128i *)out_mask->bits;
+    _mm_storeu_si128(vout, _mm_andnot_si128(_mm_loadu_si128(vb), _mm_loadu_si128(va)));
+    _mm_storeu_si128(vout + 1, _mm_andnot_si128(_mm_loadu_si128(vb + 1), _mm_loadu_si128(va + 1)));
+#else
+    for (u32 i = 0; i < INPUT_KEY_MASK_WORDS; ++i)
+    {
+        out_mask->bits[i] = a->keys[i] & ~b->keys[i];
+    }
+#endif
+}
+
 void input_initialize()
 {
     initialized = true;
@@ -34,6 +72,8 @@ void input_initialize()
 
 void input_shutdown()
 {
+    input_recorder_shutdown();
+    input_actions_shutdown();
     initialized = false;
 }
 
@@ -44,78 +84,108 @@ void input_update(f64 delta_time)
         return;
     }
 
-    rccopy_memory(&state.keyboard_previous, &state.keyboard_current, sizeof(keyboard_state));
-    rccopy_memory(&state.mouse_previous, &state.mouse_current, sizeof(mouse_state));
+    // Actions take their previous-frame state from the input as it stands before rolling over.
+    input_actions_update();
+
+    state.keyboard_previous = state.keyboard_current;
+    state.mouse_previous = state.mouse_current;
 }
 
 void input_process_key(keys key, b8 pressed)
 {
+    if (!input_recorder_accepts_input() || (u32)key >= INPUT_KEY_MASK_WORDS * 64)
+    {
+        return;
+    }
+
     if (key == KEY_LALT)
     {
-        RCINFO("Left alt pressed.");
+        RCLOG(INPUT, LOG_LEVEL_DEBUG, "Left alt pressed.");
     }
     else if (key == KEY_RALT)
     {
-        RCINFO("Right alt pressed.");
+        RCLOG(INPUT, LOG_LEVEL_DEBUG, "Right alt pressed.");
     }
     else if (key == KEY_LCONTROL)
     {
-        RCINFO("Left control pressed.");
+        RCLOG(INPUT, LOG_LEVEL_DEBUG, "Left control pressed.");
     }
     else if (key == KEY_RCONTROL)
     {
-        RCINFO("Right control pressed.");
+        RCLOG(INPUT, LOG_LEVEL_DEBUG, "Right control pressed.");
     }
     else if (key == KEY_LSHIFT)
     {
-        RCINFO("Left shift pressed.");
+        RCLOG(INPUT, LOG_LEVEL_DEBUG, "Left shift pressed.");
     }
     else if (key == KEY_RSHIFT)
     {
-        RCINFO("Right shift pressed.");
+        RCLOG(INPUT, LOG_LEVEL_DEBUG, "Right shift pressed.");
     }
 
-    if (state.keyboard_current.keys[key] != pressed)
+    if (key_bit(&state.keyboard_current, key) != pressed)
     {
-        state.keyboard_current.keys[key] = pressed;
+        state.keyboard_current.keys[(u32)key >> 6] ^= 1ull << ((u32)key & 63);
+        input_recorder_capture(INPUT_RECORD_KEY, (i16)key, pressed, 0);
+        input_actions_invalidate();
 
         event_context context;
         context.data.u16[0] = key;
-        event_fire(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, context);
+        event_post(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, context);
     }
 }
 
 void input_process_button(buttons button, b8 pressed)
 {
-    if (state.mouse_current.buttons[button] != pressed)
+    if (!input_recorder_accepts_input())
+    {
+        return;
+    }
+
+    if (button_bit(&state.mouse_current, button) != pressed)
     {
-        state.mouse_current.buttons[button] = pressed;
+        state.mouse_current.buttons ^= (u8)(1 << button);
+        input_recorder_capture(INPUT_RECORD_BUTTON, (i16)button, pressed, 0);
+        input_actions_invalidate();
         event_context context;
         context.data.u16[0] = button;
-        event_fire(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, context);
+        event_post(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, context);
     }
 }
 
 void input_process_mouse_move(i16 x, i16 y)
 {
+    if (!input_recorder_accepts_input())
+    {
+        return;
+    }
+
     if (state.mouse_current.x != x || state.mouse_current.y != y)
     {
         // RCDEBUG("Mouse pos: %i, %i", x, y);
         state.mouse_current.x = x;
         state.mouse_current.y = y;
+        input_recorder_capture(INPUT_RECORD_MOUSE_MOVE, 0, x, y);
 
         event_context context;
         context.data.u16[0] = x;
         context.data.u16[1] = y;
-        event_fire(EVENT_CODE_MOUSE_MOVED, 0, context);
+        event_post(EVENT_CODE_MOUSE_MOVED, 0, context);
     }
 }
 
 void input_process_mouse_wheel(i8 z_delta)
 {
+    if (!input_recorder_accepts_input())
+    {
+        return;
+    }
+
+    input_recorder_capture(INPUT_RECORD_MOUSE_WHEEL, z_delta, 0, 0);
+
     event_context context;
-    context.data.u8[0] = z_delta;
-    event_fire(EVENT_CODE_MOUSE_WHEEL, 0, context);
+    context.data.i8[0] = z_delta;
+    event_post(EVENT_CODE_MOUSE_WHEEL, 0, context);
 }
 
 b8 input_is_key_down(keys key)
@@ -125,7 +195,7 @@ b8 input_is_key_down(keys key)
         return false;
     }
 
-    return state.keyboard_current.keys[key] == true;
+    return key_bit(&state.keyboard_current, key);
 }
 
 b8 input_is_key_up(keys key)
@@ -135,7 +205,7 @@ b8 input_is_key_up(keys key)
         return true;
     }
 
-    return state.keyboard_current.keys[key] == false;
+    return !key_bit(&state.keyboard_current, key);
 }
 
 b8 input_was_key_down(keys key)
@@ -145,7 +215,7 @@ b8 input_was_key_down(keys key)
         return false;
     }
 
-    return state.keyboard_previous.keys[key] == true;
+    return key_bit(&state.keyboard_previous, key);
 }
 
 b8 input_was_key_up(keys key)
@@ -155,7 +225,7 @@ b8 input_was_key_up(keys key)
         return true;
     }
 
-    return state.keyboard_previous.keys[key] == false;
+    return !key_bit(&state.keyboard_previous, key);
 }
 
 b8 input_is_button_down(buttons button)
@@ -165,7 +235,7 @@ b8 input_is_button_down(buttons button)
         return false;
     }
 
-    return state.mouse_current.buttons[button] == true;
+    return button_bit(&state.mouse_current, button);
 }
 
 b8 input_is_button_up(buttons button)
@@ -175,7 +245,7 @@ b8 input_is_button_up(buttons button)
         return true;
     }
 
-    return state.mouse_current.buttons[button] == false;
+    return !button_bit(&state.mouse_current, button);
 }
 
 b8 input_was_button_down(buttons button)
@@ -185,7 +255,7 @@ b8 input_was_button_down(buttons button)
         return false;
     }
 
-    return state.mouse_previous.buttons[button] == true;
+    return button_bit(&state.mouse_previous, button);
 }
 
 b8 input_was_button_up(buttons button)
@@ -195,7 +265,7 @@ b8 input_was_button_up(buttons button)
         return true;
     }
 
-    return state.mouse_previous.buttons[button] == false;
+    return !button_bit(&state.mouse_previous, button);
 }
 
 void input_get_mouse_position(i32 *x, i32 *y)
@@ -222,4 +292,53 @@ void input_get_previous_mouse_position(i32 *x, i32 *y)
 
     *x = state.mouse_previous.x;
     *y = state.mouse_previous.y;
-}
\ No newline at end of file
+}
+
+void input_get_keys_down(input_key_mask *out_mask)
+{
+    if (!initialized)
+    {
+        rczero_memory(out_mask, sizeof(input_key_mask));
+        return;
+    }
+
+    rccopy_memory(out_mask->bits, state.keyboard_current.keys, sizeof(input_key_mask));
+}
+
+void input_get_keys_pressed(input_key_mask *out_mask)
+{
+    if (!initialized)
+    {
+        rczero_memory(out_mask, sizeof(input_key_mask));
+        return;
+    }
+
+    key_mask_and_not(&state.keyboard_current, &state.keyboard_previous, out_mask);
+}
+
+void input_get_keys_released(input_key_mask *out_mask)
+{
+    if (!initialized)
+    {
+        rczero_memory(out_mask, sizeof(input_key_mask));
+        return;
+    }
+
+    key_mask_and_not(&state.keyboard_previous, &state.keyboard_current, out_mask);
+}
+
+b8 input_key_mask_next(input_key_mask *mask, keys *out_key)
+{
+    for (u32 i = 0; i < INPUT_KEY_MASK_WORDS; ++i)
+    {
+        u64 word = mask->bits[i];
+        if (word)
+        {
+            *out_key = (keys)(i * 64 + count_trailing_zeros_u64(word));
+            // Clear the lowest set bit.
+            mask->bits[i] = word & (word - 1);
+            return true;
+        }
+    }
+    return false;
+}
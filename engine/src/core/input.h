@@ -143,15 +143,57 @@ typedef enum keys
     KEY_MAX_KEYS
 } keys;
 
-void input_initialize();
-void input_shutdown();
-void input_update(f64 delta_time);
+#define INPUT_KEY_MASK_WORDS 4
+
+/**
+ * A set of keys, one bit per key code. Walk it with input_key_mask_next.
+ */
+typedef struct input_key_mask
+{
+    u64 bits[INPUT_KEY_MASK_WORDS];
+} input_key_mask;
+
+RCAPI void input_initialize();
+RCAPI void input_shutdown();
+RCAPI void input_update(f64 delta_time);
 
 RCAPI b8 input_is_key_down(keys key);
 RCAPI b8 input_is_key_up(keys key);
 RCAPI b8 input_was_key_down(keys key);
 RCAPI b8 input_was_key_up(keys key);
 
+/**
+ * Gets every key currently held down.
+ * @param out_mask A pointer to hold the keys.
+ */
+RCAPI void input_get_keys_down(input_key_mask *out_mask);
+
+/**
+ * Gets the keys that went down since the last input_update, i.e. this frame.
+ * @param out_mask A pointer to hold the keys.
+ */
+RCAPI void input_get_keys_pressed(input_key_mask *out_mask);
+
+/**
+ * Gets the keys that went up since the last input_update, i.e. this frame.
+ * @param out_mask A pointer to hold the keys.
+ */
+RCAPI void input_get_keys_released(input_key_mask *out_mask);
+
+/**
+ * Takes the lowest key out of a mask, so only keys that are set are visited:
+ *
+ *     input_key_mask pressed;
+ *     input_get_keys_pressed(&pressed);
+ *     keys key;
+ *     while (input_key_mask_next(&pressed, &key)) { ... }
+ *
+ * @param mask The mask to take from. The returned key is cleared from it.
+ * @param out_key A pointer to hold the key.
+ * @returns true if a key was taken; false if the mask is empty.
+ */
+RCAPI b8 input_key_mask_next(input_key_mask *mask, keys *out_key);
+
 void input_process_key(keys key, b8 pressed);
 
 // Mouse input.
@@ -0,0 +1,293 @@
+#include "core/input_actions.h"
+
+#include "core/rchash.h"
+#include "core/rcmemory.h"
+#include "core/logger.h"
+
+// Must be a power of 2, and larger than INPUT_MAX_ACTIONS to keep probe chains short.
+#define ACTION_TABLE_SIZE (INPUT_MAX_ACTIONS * 2)
+#define ACTION_TABLE_MASK (ACTION_TABLE_SIZE - 1)
+
+typedef enum binding_type
+{
+    BINDING_TYPE_KEY,
+    BINDING_TYPE_BUTTON
+} binding_type;
+
+typedef struct input_binding
+{
+    u16 action_index;
+    u16 code;
+    u8 type;
+    u8 modifiers;
+} input_binding;
+
+typedef struct input_action
+{
+    u64 id;
+    // This action's range in the compiled bindings.
+    u16 first_binding;
+    u16 binding_count;
+    b8 down;
+    b8 was_down;
+} input_action;
+
+typedef struct input_actions_state
+{
+    // Open-addressed id -> action lookup. Holds action index + 1, or 0 for an empty slot.
+    u16 table[ACTION_TABLE_SIZE];
+    input_action actions[INPUT_MAX_ACTIONS];
+    u32 action_count;
+
+    // Bindings in the order they were added.
+    input_binding bindings[INPUT_MAX_BINDINGS];
+    u32 binding_count;
+    // The same bindings grouped by action, which is what evaluation walks.
+    input_binding compiled[INPUT_MAX_BINDINGS];
+
+    b8 needs_compile;
+    b8 needs_evaluate;
+} input_actions_state;
+
+static input_actions_state state;
+
+u64 input_action_id(const char *name)
+{
+    u64 id = rchash_string64(name, 0);
+    // 0 is kept free so callers can use it as "not looked up yet".
+    return id ? id : 1;
+}
+
+static input_action *action_find(u64 id)
+{
+    for (u32 slot = (u32)id & ACTION_TABLE_MASK;; slot = (slot + 1) & ACTION_TABLE_MASK)
+    {
+        u16 entry = state.table[slot];
+        if (entry == 0)
+        {
+            return 0;
+        }
+        if (state.actions[entry - 1].id == id)
+        {
+            return &state.actions[entry - 1];
+        }
+    }
+}
+
+static input_action *action_get_or_create(const char *name)
+{
+    u64 id = input_action_id(name);
+    u32 slot = (u32)id & ACTION_TABLE_MASK;
+    for (;; slot = (slot + 1) & ACTION_TABLE_MASK)
+    {
+        u16 entry = state.table[slot];
+        if (entry == 0)
+        {
+            break;
+        }
+        if (state.actions[entry - 1].id == id)
+        {
+            return &state.actions[entry - 1];
+        }
+    }
+
+    if (state.action_count == INPUT_MAX_ACTIONS)
+    {
+        RCERROR("input_action - cannot add action '%s', the limit of %u actions is reached.", name, INPUT_MAX_ACTIONS);
+        return 0;
+    }
+
+    input_action *action = &state.actions[state.action_count++];
+    rczero_memory(action, sizeof(input_action));
+    action->id = id;
+    state.table[slot] = (u16)state.action_count;
+    return action;
+}
+
+static b8 bind(const char *name, binding_type type, u16 code, u32 modifiers)
+{
+    input_action *action = action_get_or_create(name);
+    if (!action)
+    {
+        return false;
+    }
+
+    if (state.binding_count == INPUT_MAX_BINDINGS)
+    {
+        RCERROR("input_action - cannot bind '%s', the limit of %u bindings is reached.", name, INPUT_MAX_BINDINGS);
+        return false;
+    }
+
+    input_binding *binding = &state.bindings[state.binding_count++];
+    binding->action_index = (u16)(action - state.actions);
+    binding->code = code;
+    binding->type = (u8)type;
+    binding->modifiers = (u8)modifiers;
+
+    state.needs_compile = true;
+    state.needs_evaluate = true;
+    return true;
+}
+
+b8 input_action_bind_key(const char *name, keys key, u32 modifiers)
+{
+    return bind(name, BINDING_TYPE_KEY, (u16)key, modifiers);
+}
+
+b8 input_action_bind_button(const char *name, buttons button, u32 modifiers)
+{
+    return bind(name, BINDING_TYPE_BUTTON, (u16)button, modifiers);
+}
+
+b8 input_action_unbind_all(const char *name)
+{
+    input_action *action = action_find(input_action_id(name));
+    if (!action)
+    {
+        return false;
+    }
+
+    u16 action_index = (u16)(action - state.actions);
+    u32 kept = 0;
+    for (u32 i = 0; i < state.binding_count; ++i)
+    {
+        if (state.bindings[i].action_index != action_index)
+        {
+            state.bindings[kept++] = state.bindings[i];
+        }
+    }
+    state.binding_count = kept;
+
+    state.needs_compile = true;
+    state.needs_evaluate = true;
+    return true;
+}
+
+/**
+ * Groups the bindings by action with a counting sort, so each action's
+ * bindings are contiguous and keep the order they were added in.
+ */
+static void compile_bindings()
+{
+    for (u32 a = 0; a < state.action_count; ++a)
+    {
+        state.actions[a].binding_count = 0;
+    }
+    for (u32 i = 0; i < state.binding_count; ++i)
+    {
+        state.actions[state.bindings[i].action_index].binding_count++;
+    }
+
+    u16 offset = 0;
+    for (u32 a = 0; a < state.action_count; ++a)
+    {
+        state.actions[a].first_binding = offset;
+        offset += state.actions[a].binding_count;
+        // Reused as the write cursor below.
+        state.actions[a].binding_count = 0;
+    }
+
+    for (u32 i = 0; i < state.binding_count; ++i)
+    {
+        input_action *action = &state.actions[state.bindings[i].action_index];
+        state.compiled[action->first_binding + action->binding_count++] = state.bindings[i];
+    }
+
+    state.needs_compile = false;
+}
+
+static u32 held_modifiers()
+{
+    u32 modifiers = INPUT_MODIFIER_NONE;
+    if (input_is_key_down(KEY_SHIFT) || input_is_key_down(KEY_LSHIFT) || input_is_key_down(KEY_RSHIFT))
+    {
+        modifiers |= INPUT_MODIFIER_SHIFT;
+    }
+    if (input_is_key_down(KEY_CONTROL) || input_is_key_down(KEY_LCONTROL) || input_is_key_down(KEY_RCONTROL))
+    {
+        modifiers |= INPUT_MODIFIER_CONTROL;
+    }
+    if (input_is_key_down(KEY_LALT) || input_is_key_down(KEY_RALT))
+    {
+        modifiers |= INPUT_MODIFIER_ALT;
+    }
+    return modifiers;
+}
+
+static void evaluate_actions()
+{
+    if (state.needs_compile)
+    {
+        compile_bindings();
+    }
+
+    u32 modifiers = held_modifiers();
+    for (u32 a = 0; a < state.action_count; ++a)
+    {
+        input_action *action = &state.actions[a];
+        const input_binding *binding = &state.compiled[action->first_binding];
+        b8 down = false;
+        for (u32 b = 0; b < action->binding_count && !down; ++b, ++binding)
+        {
+            if ((binding->modifiers & modifiers) != binding->modifiers)
+            {
+                continue;
+            }
+
+            down = binding->type == BINDING_TYPE_KEY ? input_is_key_down((keys)binding->code) : input_is_button_down((buttons)binding->code);
+        }
+        action->down = down;
+    }
+
+    state.needs_evaluate = false;
+}
+
+static const input_action *action_query(u64 action_id)
+{
+    if (state.needs_evaluate)
+    {
+        evaluate_actions();
+    }
+    return action_find(action_id);
+}
+
+b8 input_action_is_down(u64 action_id)
+{
+    const input_action *action = action_query(action_id);
+    return action && action->down;
+}
+
+b8 input_action_pressed(u64 action_id)
+{
+    const input_action *action = action_query(action_id);
+    return action && action->down && !action->was_down;
+}
+
+b8 input_action_released(u64 action_id)
+{
+    const input_action *action = action_query(action_id);
+    return action && !action->down && action->was_down;
+}
+
+void input_actions_update()
+{
+    if (state.needs_evaluate)
+    {
+        evaluate_actions();
+    }
+
+    for (u32 a = 0; a < state.action_count; ++a)
+    {
+        state.actions[a].was_down = state.actions[a].down;
+    }
+}
+
+void input_actions_invalidate()
+{
+    state.needs_evaluate = true;
+}
+
+void input_actions_shutdown()
+{
+    rczero_memory(&state, sizeof(state));
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "defines.h"
+#include "core/input.h"
+
+/**
+ * Named input actions on top of the raw key and button state. Each action is
+ * bound to any number of keys or mouse buttons, optionally with modifiers, and
+ * is down while any of its bindings is satisfied. Bindings can be changed at
+ * runtime, so controls can be remapped without touching gameplay code.
+ *
+ * Actions are identified by the hash of their name. Look the id up once with
+ * input_action_id and query by id:
+ *
+ *     static u64 jump = 0;
+ *     if (!jump) jump = input_action_id("jump");
+ *     if (input_action_pressed(jump)) { ... }
+ *
+ * Bindings are compiled into one flat table, grouped by action, the first
+ * time actions are queried after a change. Actions are evaluated once per
+ * frame, and again only if input arrived since. Main thread only.
+ */
+
+#define INPUT_MAX_ACTIONS 256
+#define INPUT_MAX_BINDINGS 1024
+
+typedef enum input_modifier
+{
+    INPUT_MODIFIER_NONE = 0x0,
+    // Either shift key.
+    INPUT_MODIFIER_SHIFT = 0x1,
+    // Either control key.
+    INPUT_MODIFIER_CONTROL = 0x2,
+    // Either alt key.
+    INPUT_MODIFIER_ALT = 0x4
+} input_modifier;
+
+/**
+ * Gets the id of an action name. The same name always gives the same id.
+ * @param name The action name, e.g. "jump".
+ * @returns The action id. Never 0.
+ */
+RCAPI u64 input_action_id(const char *name);
+
+/**
+ * Binds a key to an action, creating the action if needed. The modifiers must
+ * be held as well; modifiers not listed are ignored, so a binding without
+ * modifiers also triggers while shift is held.
+ * @param name The action name.
+ * @param key The key.
+ * @param modifiers Combination of input_modifier flags.
+ * @returns true on success; false if the action or binding limit is reached.
+ */
+RCAPI b8 input_action_bind_key(const char *name, keys key, u32 modifiers);
+
+/**
+ * Binds a mouse button to an action, creating the action if needed. Modifiers
+ * work as for input_action_bind_key.
+ * @param name The action name.
+ * @param button The mouse button.
+ * @param modifiers Combination of input_modifier flags.
+ * @returns true on success; false if the action or binding limit is reached.
+ */
+RCAPI b8 input_action_bind_button(const char *name, buttons button, u32 modifiers);
+
+/**
+ * Removes every binding of an action. The action stays known and reads as up.
+ * @param name The action name.
+ * @returns true if the action exists; otherwise false.
+ */
+RCAPI b8 input_action_unbind_all(const char *name);
+
+/**
+ * Returns true while any binding of the action is held.
+ */
+RCAPI b8 input_action_is_down(u64 action_id);
+
+/**
+ * Returns true if the action went down since the last input_update.
+ */
+RCAPI b8 input_action_pressed(u64 action_id);
+
+/**
+ * Returns true if the action went up since the last input_update.
+ */
+RCAPI b8 input_action_released(u64 action_id);
+
+/**
+ * Evaluates every action and keeps the result as the previous frame's state.
+ * Called by input_update before it rolls the key state over.
+ */
+void input_actions_update();
+
+/**
+ * Marks the action state stale. Called by the input system when input arrives.
+ */
+void input_actions_invalidate();
+
+/**
+ * Removes every action and binding. Called by input_shutdown.
+ */
+void input_actions_shutdown();
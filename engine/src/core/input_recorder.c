@@ -0,0 +1,260 @@
+#include "core/input_recorder.h"
+
+#include "core/input.h"
+#include "core/event.h"
+#include "core/rcmemory.h"
+#include "core/logger.h"
+#include "platform/filesystem.h"
+
+#define INPUT_RECORDING_MAGIC 0x4E494352 // "RCIN"
+#define INPUT_RECORDING_VERSION 1
+
+typedef struct input_recording_header
+{
+    u32 magic;
+    u16 version;
+    u16 record_size;
+} input_recording_header;
+
+/* One input change. Files are a header followed by these in the order they were applied. */
+typedef struct input_record
+{
+    u32 frame;
+    u8 type;
+    u8 reserved;
+    i16 code;
+    i16 x;
+    i16 y;
+} input_record;
+
+STATIC_ASSERT(sizeof(input_recording_header) == 8, "input_recording_header must be 8 bytes.");
+STATIC_ASSERT(sizeof(input_record) == 12, "input_record must be 12 bytes.");
+
+typedef struct input_recorder_state
+{
+    u32 frame;
+
+    b8 recording;
+    file_handle file;
+
+    b8 playing_back;
+    b8 injecting;
+    b8 quit_when_done;
+    input_record *records;
+    u64 record_count;
+    u64 cursor;
+    // Frame of the END record, or of the last record if the file was cut short.
+    u32 last_frame;
+} input_recorder_state;
+
+static input_recorder_state state;
+
+static b8 write_record(input_record_type type, i16 code, i16 x, i16 y)
+{
+    input_record record;
+    record.frame = state.frame;
+    record.type = (u8)type;
+    record.reserved = 0;
+    record.code = code;
+    record.x = x;
+    record.y = y;
+
+    u64 written = 0;
+    return filesystem_write(&state.file, sizeof(record), &record, &written);
+}
+
+b8 input_recording_begin(const char *path)
+{
+    if (state.recording || state.playing_back)
+    {
+        RCERROR("input_recording_begin - a recording or playback is already running.");
+        return false;
+    }
+
+    if (!filesystem_open(path, FILE_MODE_WRITE, true, &state.file))
+    {
+        return false;
+    }
+
+    input_recording_header header = {INPUT_RECORDING_MAGIC, INPUT_RECORDING_VERSION, sizeof(input_record)};
+    u64 written = 0;
+    if (!filesystem_write(&state.file, sizeof(header), &header, &written))
+    {
+        RCERROR("input_recording_begin - failed to write header to '%s'.", path);
+        filesystem_close(&state.file);
+        return false;
+    }
+
+    state.frame = 0;
+    state.recording = true;
+    RCINFO("Recording input to '%s'.", path);
+    return true;
+}
+
+b8 input_recording_end()
+{
+    if (!state.recording)
+    {
+        return false;
+    }
+
+    // Marks how many frames the recording spans, including trailing frames without input.
+    write_record(INPUT_RECORD_END, 0, 0, 0);
+    filesystem_close(&state.file);
+    state.recording = false;
+    RCINFO("Input recording stopped after %u frames.", state.frame);
+    return true;
+}
+
+b8 input_playback_begin(const char *path, b8 quit_when_done)
+{
+    if (state.recording || state.playing_back)
+    {
+        RCERROR("input_playback_begin - a recording or playback is already running.");
+        return false;
+    }
+
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_READ, true, &file))
+    {
+        return false;
+    }
+
+    u64 size = 0;
+    u64 read = 0;
+    input_recording_header header;
+    if (!filesystem_size(&file, &size) || size < sizeof(header) || !filesystem_read(&file, sizeof(header), &header, &read) ||
+        header.magic != INPUT_RECORDING_MAGIC || header.version != INPUT_RECORDING_VERSION || header.record_size != sizeof(input_record))
+    {
+        RCERROR("input_playback_begin - '%s' is not a version %u input recording.", path, INPUT_RECORDING_VERSION);
+        filesystem_close(&file);
+        return false;
+    }
+
+    // A recording cut short by a crash may end in a partial record; ignore it.
+    u64 record_count = (size - sizeof(header)) / sizeof(input_record);
+    input_record *records = 0;
+    if (record_count)
+    {
+        records = rcallocate(sizeof(input_record) * record_count, MEMORY_TAG_ARRAY);
+        if (!filesystem_read(&file, sizeof(input_record) * record_count, records, &read))
+        {
+            RCERROR("input_playback_begin - failed to read '%s'.", path);
+            rcfree(records, sizeof(input_record) * record_count, MEMORY_TAG_ARRAY);
+            filesystem_close(&file);
+            return false;
+        }
+    }
+    filesystem_close(&file);
+
+    state.records = records;
+    state.record_count = record_count;
+    state.cursor = 0;
+    state.last_frame = record_count ? records[record_count - 1].frame : 0;
+    state.frame = 0;
+    state.quit_when_done = quit_when_done;
+    state.playing_back = true;
+    RCINFO("Playing back %u frames of input from '%s'.", state.last_frame, path);
+    return true;
+}
+
+void input_playback_end()
+{
+    if (!state.playing_back)
+    {
+        return;
+    }
+
+    if (state.records)
+    {
+        rcfree(state.records, sizeof(input_record) * state.record_count, MEMORY_TAG_ARRAY);
+        state.records = 0;
+    }
+    state.record_count = 0;
+    state.cursor = 0;
+    state.playing_back = false;
+}
+
+b8 input_is_recording()
+{
+    return state.recording;
+}
+
+b8 input_is_playing_back()
+{
+    return state.playing_back;
+}
+
+b8 input_recorder_frame_begin()
+{
+    state.frame++;
+    if (!state.playing_back)
+    {
+        return true;
+    }
+
+    state.injecting = true;
+    while (state.cursor < state.record_count && state.records[state.cursor].frame <= state.frame)
+    {
+        const input_record *record = &state.records[state.cursor++];
+        switch (record->type)
+        {
+        case INPUT_RECORD_KEY:
+            input_process_key((keys)record->code, record->x != 0);
+            break;
+        case INPUT_RECORD_BUTTON:
+            input_process_button((buttons)record->code, record->x != 0);
+            break;
+        case INPUT_RECORD_MOUSE_MOVE:
+            input_process_mouse_move(record->x, record->y);
+            break;
+        case INPUT_RECORD_MOUSE_WHEEL:
+            input_process_mouse_wheel((i8)record->code);
+            break;
+        default:
+            break;
+        }
+    }
+    state.injecting = false;
+
+    if (state.frame <= state.last_frame)
+    {
+        return true;
+    }
+
+    RCINFO("Input playback finished after %u frames.", state.frame);
+    b8 quit = state.quit_when_done;
+    input_playback_end();
+    if (quit)
+    {
+        event_context context = {0};
+        event_post(EVENT_CODE_APPLICATION_QUIT, 0, context);
+    }
+    return false;
+}
+
+b8 input_recorder_accepts_input()
+{
+    return !state.playing_back || state.injecting;
+}
+
+void input_recorder_capture(input_record_type type, i16 code, i16 x, i16 y)
+{
+    if (!state.recording)
+    {
+        return;
+    }
+
+    if (!write_record(type, code, x, y))
+    {
+        RCERROR("input_recorder_capture - write failed, recording stopped.");
+        filesystem_close(&state.file);
+        state.recording = false;
+    }
+}
+
+void input_recorder_shutdown()
+{
+    input_recording_end();
+    input_playback_end();
+}
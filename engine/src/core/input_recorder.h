@@ -0,0 +1,92 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * Records the changes applied to the keyboard and mouse state each frame and
+ * plays them back through input_process_key, input_process_button,
+ * input_process_mouse_move and input_process_mouse_wheel. Playback needs no
+ * window or platform layer, so it doubles as a headless input driver: set
+ * application_config.headless along with input_playback_path, or, without the
+ * application, initialize the event and input systems, start a playback and
+ * call input_recorder_frame_begin, event_dispatch_queued, the game update with
+ * a fixed delta and input_update each frame. Either way every run gets the
+ * same input.
+ *
+ * Only changes are stored: a key press and its release, button presses,
+ * mouse positions that differ from the last one and wheel deltas, each tagged
+ * with its frame. A press and release within one frame are both kept.
+ *
+ * While playing back, input from the platform layer is ignored. Do not combine
+ * with an event trace replay, which would deliver the same input twice.
+ *
+ * Main thread only.
+ */
+
+/**
+ * Starts recording input to the provided file, replacing its contents.
+ * @param path The file to write.
+ * @returns true if recording started; false if already recording or playing back, or the file could not be opened.
+ */
+RCAPI b8 input_recording_begin(const char *path);
+
+/**
+ * Stops recording and closes the file.
+ * @returns true if a recording was in progress; otherwise false.
+ */
+RCAPI b8 input_recording_end();
+
+/**
+ * Loads a recording and starts playing it back. Input recorded before the
+ * first frame is applied with that of frame 1.
+ * @param path The file to read.
+ * @param quit_when_done If true, EVENT_CODE_APPLICATION_QUIT is posted once every recorded frame has been played.
+ * @returns true if playback started; false if already recording or playing back, or the file is missing or invalid.
+ */
+RCAPI b8 input_playback_begin(const char *path, b8 quit_when_done);
+
+/**
+ * Stops playback and returns to live input.
+ */
+RCAPI void input_playback_end();
+
+RCAPI b8 input_is_recording();
+RCAPI b8 input_is_playing_back();
+
+/**
+ * Marks the start of a frame. Call once per frame before platform messages
+ * are pumped, or in its place when running headless. When playing back, this
+ * is where the frame's recorded input is applied.
+ * @returns false on the first frame after a playback has played every recorded frame; otherwise true.
+ */
+RCAPI b8 input_recorder_frame_begin();
+
+/**
+ * Called by the input system before applying input.
+ * @returns false if the input comes from the platform while a playback is running and must be ignored.
+ */
+b8 input_recorder_accepts_input();
+
+typedef enum input_record_type
+{
+    INPUT_RECORD_KEY = 1,
+    INPUT_RECORD_BUTTON = 2,
+    INPUT_RECORD_MOUSE_MOVE = 3,
+    INPUT_RECORD_MOUSE_WHEEL = 4,
+    // Written when recording ends, at the last recorded frame.
+    INPUT_RECORD_END = 5
+} input_record_type;
+
+/**
+ * Called by the input system for each change it applies. Records it if recording.
+ * @param type What changed.
+ * @param code The key or button; the wheel delta for INPUT_RECORD_MOUSE_WHEEL.
+ * @param x For keys and buttons, 1 if pressed and 0 if released; the x position for moves.
+ * @param y The y position for moves; otherwise 0.
+ */
+void input_recorder_capture(input_record_type type, i16 code, i16 x, i16 y);
+
+/**
+ * Ends any recording or playback. Called by input_shutdown.
+ */
+void input_recorder_shutdown();
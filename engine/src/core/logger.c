@@ -1,53 +1,672 @@
 #include "logger.h"
 #include "asserts.h"
 #include "platform/platform.h"
+#include "platform/filesystem.h"
+#include "core/rcmemory.h"
+#include "core/rcstring.h"
+#include "core/string_builder.h"
 
-// TODO: temporary
-#include <stdio.h>
-#include <string.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 
 #define MSG_LENGTH 32000
 
+#define LOG_FILE_PATH "console.log"
+
+/**
+ * Records travel from producers to the writer thread through a ring of
+ * fixed-size slots. A record takes as many consecutive slots as its text
+ * needs, up to LOG_MAX_RECORD_SLOTS; longer text is truncated.
+ * LOG_SLOT_COUNT must be a power of 2.
+ */
+#define LOG_SLOT_SIZE 256
+#define LOG_SLOT_COUNT 2048
+#define LOG_SLOT_MASK (LOG_SLOT_COUNT - 1)
+#define LOG_SLOT_DATA_SIZE (LOG_SLOT_SIZE - sizeof(u64))
+#define LOG_MAX_RECORD_SLOTS 64
+#define LOG_MAX_RECORD_LENGTH (LOG_MAX_RECORD_SLOTS * LOG_SLOT_DATA_SIZE - sizeof(log_record_header))
+
+// How long the writer sleeps when there is nothing to write, bounding the latency of a message.
+#define LOG_WRITER_IDLE_MS 10
+// How long a blocking producer waits for room before dropping its message.
+#define LOG_BLOCK_TIMEOUT_MS 100
+// Text collected for the log file before a write is issued.
+#define LOG_FILE_BATCH_SIZE (64 * 1024)
+// Text collected for the console before a write is issued.
+#define LOG_CONSOLE_BATCH_SIZE (16 * 1024)
+// Largest packed argument block a deferred record may carry; bigger ones are formatted immediately.
+#define LOG_DEFERRED_ARGS_SIZE 1024
+
+/**
+ * A slot is free for the producer at position p when its sequence is p, and
+ * holds a published record chunk for the writer when it is p + 1. The writer
+ * frees it for the next lap by setting p + LOG_SLOT_COUNT.
+ */
+typedef struct log_slot
+{
+    _Atomic u64 sequence;
+    u8 data[LOG_SLOT_DATA_SIZE];
+} log_slot;
+
+// The record body is a format string pointer followed by arguments from string_format_pack_v, instead of text.
+#define LOG_RECORD_DEFERRED 0x1
+
+// Starts the first slot of every record; the body follows it.
+typedef struct log_record_header
+{
+    u32 length;
+    u16 slot_count;
+    u8 level;
+    u8 flags;
+    // Seconds, from platform_get_absolute_time when the message was logged.
+    f64 timestamp;
+} log_record_header;
+
+typedef struct logger_state
+{
+    log_slot *slots;
+
+    // Advanced by producers to claim slots.
+    _Atomic u64 enqueue_position;
+    u8 enqueue_padding[56];
+    // Advanced by the writer thread only.
+    _Atomic u64 dequeue_position;
+    u8 dequeue_padding[56];
+
+    _Atomic u32 dropped;
+    _Atomic u32 full_policy;
+    // Makes log_output_deferred format on the calling thread.
+    _Atomic b8 immediate_formatting;
+    // Set while the writer is about to sleep, so producers know to wake it.
+    _Atomic b8 writer_idle;
+    _Atomic b8 running;
+
+    platform_thread writer;
+    platform_semaphore wake;
+    file_handle file;
+
+    // Writer thread only.
+    char file_batch[LOG_FILE_BATCH_SIZE];
+    u64 file_batch_length;
+    // Every record in the console batch has this level, which picks the stream and colour.
+    char console_batch[LOG_CONSOLE_BATCH_SIZE + 1];
+    u64 console_batch_length;
+    log_level console_batch_level;
+} logger_state;
+
+static const char *level_strings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ", "[TRACE]: "};
+
+static b8 initialized = false;
+static logger_state state;
+
+static u8 category_levels[LOG_CATEGORY_MAX] = {
+    LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE,
+    LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE};
+STATIC_ASSERT(LOG_CATEGORY_MAX == 8, "Update category_levels when adding a log category.");
+
+static u32 log_writer_thread(void *params);
+
 b8 initialize_logging()
 {
-    // TODO: create log file
+    if (initialized)
+    {
+        return false;
+    }
+
+    state.slots = rcallocate(sizeof(log_slot) * LOG_SLOT_COUNT, MEMORY_TAG_RING_QUEUE);
+    for (u64 i = 0; i < LOG_SLOT_COUNT; ++i)
+    {
+        atomic_init(&state.slots[i].sequence, i);
+    }
+    atomic_init(&state.enqueue_position, 0);
+    atomic_init(&state.dequeue_position, 0);
+    atomic_init(&state.dropped, 0);
+    atomic_init(&state.writer_idle, false);
+    atomic_init(&state.running, true);
+    state.file_batch_length = 0;
+    state.console_batch_length = 0;
+
+    if (!filesystem_open(LOG_FILE_PATH, FILE_MODE_WRITE, false, &state.file))
+    {
+        platform_console_write_error("[ERROR]: Unable to open " LOG_FILE_PATH " for writing, logging to the console only.\n", LOG_LEVEL_ERROR);
+    }
+
+    if (!platform_semaphore_create(0, &state.wake) || !platform_thread_create(log_writer_thread, 0, &state.writer))
+    {
+        platform_console_write_error("[ERROR]: Unable to start the log writer thread, logging synchronously.\n", LOG_LEVEL_ERROR);
+        platform_semaphore_destroy(&state.wake);
+        filesystem_close(&state.file);
+        rcfree(state.slots, sizeof(log_slot) * LOG_SLOT_COUNT, MEMORY_TAG_RING_QUEUE);
+        state.slots = 0;
+        return false;
+    }
+
+    initialized = true;
     return true;
 }
 
 void shutdown_logging()
 {
-    // TODO: cleanup logging/write queued entries
+    if (!initialized)
+    {
+        return;
+    }
+
+    // The writer drains everything queued before it sees running go false, then exits.
+    initialized = false;
+    atomic_store_explicit(&state.running, false, memory_order_release);
+    platform_semaphore_signal(&state.wake);
+    platform_thread_join(&state.writer);
+
+    platform_semaphore_destroy(&state.wake);
+    filesystem_close(&state.file);
+    rcfree(state.slots, sizeof(log_slot) * LOG_SLOT_COUNT, MEMORY_TAG_RING_QUEUE);
+    state.slots = 0;
 }
 
-void log_output(log_level level, const char *message, ...)
+void logger_set_full_policy(log_full_policy policy)
+{
+    atomic_store_explicit(&state.full_policy, (u32)policy, memory_order_relaxed);
+}
+
+void logger_set_deferred_formatting(b8 enabled)
+{
+    atomic_store_explicit(&state.immediate_formatting, !enabled, memory_order_relaxed);
+}
+
+void log_category_set_level(log_category category, log_level level)
+{
+    if (category < LOG_CATEGORY_MAX)
+    {
+        category_levels[category] = (u8)level;
+    }
+}
+
+b8 log_category_enabled(log_category category, log_level level)
+{
+    return category < LOG_CATEGORY_MAX && (u8)level <= category_levels[category];
+}
+
+b8 log_rate_limit_allow(log_rate_limit *limit, u32 max_per_second, const char *file, i32 line)
+{
+    f64 now = platform_get_absolute_time();
+    if (now - limit->window_start >= 1.0 || now < limit->window_start)
+    {
+        u32 suppressed = limit->suppressed;
+        limit->window_start = now;
+        limit->count = 0;
+        limit->suppressed = 0;
+        if (suppressed)
+        {
+            log_output_deferred(LOG_LEVEL_WARN, "%u messages suppressed by the rate limit at %s:%d.", suppressed, file, line);
+        }
+    }
+
+    if (limit->count < max_per_second)
+    {
+        limit->count++;
+        return true;
+    }
+
+    limit->suppressed++;
+    return false;
+}
+
+static void wake_writer()
+{
+    // Pairs with the fence in log_writer_thread: either the writer sees the
+    // record just published, or this sees writer_idle set and signals it.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&state.writer_idle, memory_order_relaxed) &&
+        atomic_exchange_explicit(&state.writer_idle, false, memory_order_acq_rel))
+    {
+        platform_semaphore_signal(&state.wake);
+    }
+}
+
+void logger_flush()
+{
+    if (!initialized)
+    {
+        return;
+    }
+
+    u64 target = atomic_load_explicit(&state.enqueue_position, memory_order_acquire);
+    platform_semaphore_signal(&state.wake);
+    for (u32 i = 0; i < LOG_BLOCK_TIMEOUT_MS * 10; ++i)
+    {
+        if ((i64)(atomic_load_explicit(&state.dequeue_position, memory_order_acquire) - target) >= 0)
+        {
+            return;
+        }
+        platform_sleep(1);
+    }
+}
+
+/**
+ * Claims slots for a record and copies it in. Lock-free; safe from any thread.
+ * @returns false if the ring has no room.
+ */
+static b8 ring_push(log_level level, u8 flags, f64 timestamp, const void *data, u64 length)
+{
+    const u8 *bytes = data;
+    if (length > LOG_MAX_RECORD_LENGTH)
+    {
+        length = LOG_MAX_RECORD_LENGTH;
+    }
+    u64 slot_count = (sizeof(log_record_header) + length + LOG_SLOT_DATA_SIZE - 1) / LOG_SLOT_DATA_SIZE;
+
+    u64 position = atomic_load_explicit(&state.enqueue_position, memory_order_relaxed);
+    for (;;)
+    {
+        b8 stale = false;
+        for (u64 i = 0; i < slot_count; ++i)
+        {
+            u64 sequence = atomic_load_explicit(&state.slots[(position + i) & LOG_SLOT_MASK].sequence, memory_order_acquire);
+            i64 difference = (i64)(sequence - (position + i));
+            if (difference < 0)
+            {
+                // Still holds a record from the previous lap.
+                return false;
+            }
+            if (difference > 0)
+            {
+                // Another producer got here first.
+                stale = true;
+                break;
+            }
+        }
+
+        if (stale)
+        {
+            position = atomic_load_explicit(&state.enqueue_position, memory_order_relaxed);
+        }
+        else if (atomic_compare_exchange_weak_explicit(&state.enqueue_position, &position, position + slot_count, memory_order_relaxed, memory_order_relaxed))
+        {
+            break;
+        }
+    }
+
+    log_record_header header = {(u32)length, (u16)slot_count, (u8)level, flags, timestamp};
+    u64 copied = 0;
+    for (u64 i = 0; i < slot_count; ++i)
+    {
+        log_slot *slot = &state.slots[(position + i) & LOG_SLOT_MASK];
+        u8 *dest = slot->data;
+        u64 space = LOG_SLOT_DATA_SIZE;
+        if (i == 0)
+        {
+            rccopy_memory(dest, &header, sizeof(header));
+            dest += sizeof(header);
+            space -= sizeof(header);
+        }
+
+        u64 chunk = length - copied < space ? length - copied : space;
+        rccopy_memory(dest, bytes + copied, chunk);
+        copied += chunk;
+
+        atomic_store_explicit(&slot->sequence, position + i + 1, memory_order_release);
+    }
+
+    return true;
+}
+
+/**
+ * Checks whether every slot of the record at the given position has been published. Writer thread only.
+ * @param out_header Receives the record's header when it is ready.
+ * @returns true if the whole record can be taken.
+ */
+static b8 ring_record_ready(u64 position, log_record_header *out_header)
+{
+    log_slot *first = &state.slots[position & LOG_SLOT_MASK];
+    if (atomic_load_explicit(&first->sequence, memory_order_acquire) != position + 1)
+    {
+        return false;
+    }
+
+    log_record_header header;
+    rccopy_memory(&header, first->data, sizeof(header));
+
+    // The rest of the record may still be being written.
+    for (u64 i = 1; i < header.slot_count; ++i)
+    {
+        if (atomic_load_explicit(&state.slots[(position + i) & LOG_SLOT_MASK].sequence, memory_order_acquire) != position + i + 1)
+        {
+            return false;
+        }
+    }
+
+    *out_header = header;
+    return true;
+}
+
+/**
+ * Takes the next record off the ring. Writer thread only.
+ * @param out_data A buffer of at least LOG_MAX_RECORD_LENGTH + 1 bytes; the body is null-terminated.
+ * @returns true if a complete record was taken.
+ */
+static b8 ring_pop(u8 *out_data, log_record_header *out_header)
+{
+    u64 position = atomic_load_explicit(&state.dequeue_position, memory_order_relaxed);
+    log_record_header header;
+    if (!ring_record_ready(position, &header))
+    {
+        return false;
+    }
+
+    u64 copied = 0;
+    for (u64 i = 0; i < header.slot_count; ++i)
+    {
+        log_slot *slot = &state.slots[(position + i) & LOG_SLOT_MASK];
+        const u8 *source = slot->data;
+        u64 available = LOG_SLOT_DATA_SIZE;
+        if (i == 0)
+        {
+            source += sizeof(header);
+            available -= sizeof(header);
+        }
+
+        u64 chunk = header.length - copied < available ? header.length - copied : available;
+        rccopy_memory(out_data + copied, source, chunk);
+        copied += chunk;
+
+        atomic_store_explicit(&slot->sequence, position + i + LOG_SLOT_COUNT, memory_order_release);
+    }
+    out_data[header.length] = 0;
+
+    atomic_store_explicit(&state.dequeue_position, position + header.slot_count, memory_order_release);
+    *out_header = header;
+    return true;
+}
+
+// True only when ring_pop would succeed, so a record still being written does not keep the writer spinning.
+static b8 ring_has_pending()
+{
+    u64 position = atomic_load_explicit(&state.dequeue_position, memory_order_relaxed);
+    log_record_header header;
+    return ring_record_ready(position, &header);
+}
+
+static void file_batch_flush()
+{
+    if (state.file_batch_length && state.file.is_valid)
+    {
+        u64 written = 0;
+        filesystem_write(&state.file, state.file_batch_length, state.file_batch, &written);
+    }
+    state.file_batch_length = 0;
+}
+
+static void file_batch_append(const char *text, u64 length)
+{
+    if (state.file_batch_length + length > LOG_FILE_BATCH_SIZE)
+    {
+        file_batch_flush();
+    }
+    if (length > LOG_FILE_BATCH_SIZE)
+    {
+        u64 written = 0;
+        if (state.file.is_valid)
+        {
+            filesystem_write(&state.file, length, text, &written);
+        }
+        return;
+    }
+    rccopy_memory(state.file_batch + state.file_batch_length, text, length);
+    state.file_batch_length += length;
+}
+
+static void console_write(const char *text, log_level level)
+{
+    if (level < LOG_LEVEL_WARN)
+    {
+        platform_console_write_error(text, level);
+    }
+    else
+    {
+        platform_console_write(text, level);
+    }
+}
+
+static void console_batch_flush()
+{
+    if (state.console_batch_length)
+    {
+        state.console_batch[state.console_batch_length] = 0;
+        console_write(state.console_batch, state.console_batch_level);
+    }
+    state.console_batch_length = 0;
+}
+
+// Text must be null-terminated at length.
+static void console_batch_append(const char *text, u64 length, log_level level)
+{
+    if (state.console_batch_length && (level != state.console_batch_level || state.console_batch_length + length > LOG_CONSOLE_BATCH_SIZE))
+    {
+        console_batch_flush();
+    }
+    if (length > LOG_CONSOLE_BATCH_SIZE)
+    {
+        console_write(text, level);
+        return;
+    }
+    rccopy_memory(state.console_batch + state.console_batch_length, text, length);
+    state.console_batch_length += length;
+    state.console_batch_level = level;
+}
+
+static void write_record(const char *text, u64 length, log_level level, f64 timestamp)
+{
+    // Consecutive records of one level reach the console in a single write.
+    console_batch_append(text, length, level);
+
+    // Lines in the file carry the time they were logged, which can be well before they were formatted.
+    char stamp[32];
+    u64 stamp_length = string_format(stamp, sizeof(stamp), "%10.4f ", timestamp);
+    file_batch_append(stamp, stamp_length);
+    file_batch_append(text, length);
+}
+
+/**
+ * Produces the text of a deferred record.
+ * @returns The text length; out_text is null-terminated.
+ */
+static u64 format_deferred(const u8 *body, u64 body_length, log_level level, char *out_text, u64 capacity)
+{
+    const char *format;
+    rccopy_memory(&format, body, sizeof(format));
+
+    u64 length = string_length(level_strings[level]);
+    rccopy_memory(out_text, level_strings[level], length);
+
+    // Leave room for the newline and terminator.
+    u64 space = capacity - length - 1;
+    u64 message_length = string_format_packed(out_text + length, space, format, body + sizeof(format), body_length - sizeof(format));
+    length += message_length < space ? message_length : space - 1;
+
+    out_text[length++] = '\n';
+    out_text[length] = 0;
+    return length;
+}
+
+/**
+ * Writes everything currently on the ring as one batch.
+ * @returns the number of records written.
+ */
+static u64 write_pending(u8 *body, char *text)
+{
+    u64 count = 0;
+    log_record_header header;
+    while (ring_pop(body, &header))
+    {
+        log_level level = (log_level)header.level;
+        if (header.flags & LOG_RECORD_DEFERRED)
+        {
+            u64 length = format_deferred(body, header.length, level, text, MSG_LENGTH);
+            write_record(text, length, level, header.timestamp);
+        }
+        else
+        {
+            write_record((const char *)body, header.length, level, header.timestamp);
+        }
+        count++;
+    }
+
+    u32 dropped = atomic_exchange_explicit(&state.dropped, 0, memory_order_relaxed);
+    if (dropped)
+    {
+        char notice[128];
+        u64 notice_length = string_format(notice, sizeof(notice), "[WARN]: %u log messages were dropped because the log ring was full.\n", dropped);
+        write_record(notice, notice_length, LOG_LEVEL_WARN, platform_get_absolute_time());
+        count++;
+    }
+
+    if (count)
+    {
+        console_batch_flush();
+        file_batch_flush();
+        if (state.file.is_valid)
+        {
+            filesystem_flush(&state.file);
+        }
+    }
+    return count;
+}
+
+static u32 log_writer_thread(void *params)
+{
+    static u8 body[LOG_MAX_RECORD_LENGTH + 1];
+    static char text[MSG_LENGTH];
+
+    for (;;)
+    {
+        // Read before draining, so everything queued before shutdown is written before exiting.
+        b8 running = atomic_load_explicit(&state.running, memory_order_acquire);
+        if (write_pending(body, text))
+        {
+            continue;
+        }
+        if (!running)
+        {
+            break;
+        }
+
+        atomic_store_explicit(&state.writer_idle, true, memory_order_relaxed);
+        // Pairs with the fence in wake_writer.
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!ring_has_pending())
+        {
+            platform_semaphore_wait(&state.wake, LOG_WRITER_IDLE_MS);
+        }
+        atomic_store_explicit(&state.writer_idle, false, memory_order_relaxed);
+    }
+
+    return 0;
+}
+
+/**
+ * Queues a record for the writer, applying the full-ring policy.
+ */
+static void log_submit(log_level level, u8 flags, const void *data, u64 length)
 {
-    const char *level_strings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ", "[TRACE]: "};
     b8 is_error = level < LOG_LEVEL_WARN;
+    f64 timestamp = platform_get_absolute_time();
+
+    b8 pushed = ring_push(level, flags, timestamp, data, length);
+    if (!pushed && (is_error || atomic_load_explicit(&state.full_policy, memory_order_relaxed) == LOG_FULL_POLICY_BLOCK))
+    {
+        // Wait a bounded time for the writer to make room.
+        for (u32 i = 0; i < LOG_BLOCK_TIMEOUT_MS && !pushed; ++i)
+        {
+            platform_semaphore_signal(&state.wake);
+            platform_sleep(1);
+            pushed = ring_push(level, flags, timestamp, data, length);
+        }
+    }
+
+    if (!pushed)
+    {
+        atomic_fetch_add_explicit(&state.dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    if (level == LOG_LEVEL_FATAL)
+    {
+        // The process may be about to go down; make sure this reaches the console and file.
+        logger_flush();
+    }
+    else
+    {
+        wake_writer();
+    }
+}
 
+static void log_output_v(log_level level, const char *message, va_list args)
+{
+    // Format the prefix, message and newline into a single buffer in one pass.
     char out_message[MSG_LENGTH];
-    memset(out_message, 0, sizeof(out_message));
+    string_builder builder;
+    string_builder_create(MSG_LENGTH, out_message, &builder);
+
+    string_builder_append(&builder, level_strings[level]);
+    string_builder_appendf_v(&builder, message, args);
+    string_builder_append_char(&builder, '\n');
+
+    if (!initialized)
+    {
+        // Before startup or after shutdown, write straight to the console.
+        if (level < LOG_LEVEL_WARN)
+        {
+            platform_console_write_error(out_message, level);
+        }
+        else
+        {
+            platform_console_write(out_message, level);
+        }
+        return;
+    }
+
+    if (builder.length > LOG_MAX_RECORD_LENGTH)
+    {
+        // Keep the line break on truncated messages.
+        out_message[LOG_MAX_RECORD_LENGTH - 1] = '\n';
+    }
 
+    log_submit(level, 0, out_message, builder.length);
+}
+
+void log_output(log_level level, const char *message, ...)
+{
     va_list arg_ptr;
     va_start(arg_ptr, message);
-    vsnprintf(out_message, MSG_LENGTH, message, arg_ptr);
+    log_output_v(level, message, arg_ptr);
     va_end(arg_ptr);
+}
 
-    char out_message2[MSG_LENGTH];
-    sprintf(out_message2, "%s%s\n", level_strings[level], out_message);
+void log_output_deferred(log_level level, const char *format, ...)
+{
+    va_list arg_ptr;
+    va_start(arg_ptr, format);
 
-    // Platform-specific output
-    if (is_error)
+    if (level >= LOG_LEVEL_WARN && initialized && !atomic_load_explicit(&state.immediate_formatting, memory_order_relaxed))
     {
-        platform_console_write_error(out_message2, level);
-    }
-    else
-    {
-        platform_console_write(out_message2, level);
+        // Only the format pointer and the raw arguments; the writer thread does the formatting.
+        u8 record[sizeof(const char *) + LOG_DEFERRED_ARGS_SIZE];
+        rccopy_memory(record, &format, sizeof(format));
+        u64 packed_size = string_format_pack_v(record + sizeof(format), LOG_DEFERRED_ARGS_SIZE, format, arg_ptr);
+        if (packed_size <= LOG_DEFERRED_ARGS_SIZE)
+        {
+            log_submit(level, LOG_RECORD_DEFERRED, record, sizeof(format) + packed_size);
+            va_end(arg_ptr);
+            return;
+        }
     }
+
+    log_output_v(level, format, arg_ptr);
+    va_end(arg_ptr);
 }
 
 void report_assertion_failure(const char *expression, const char *message, const char *file, i32 line)
 {
     log_output(LOG_LEVEL_FATAL, "Assertion failure: %s, message: '%s', in file: %s, line %d\n", expression, message, file, line);
-}
\ No newline at end of file
+}
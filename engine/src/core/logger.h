@@ -22,38 +22,210 @@ typedef enum log_level
     LOG_LEVEL_TRACE = 5
 } log_level;
 
+/** Subsystems whose messages can be filtered separately. */
+typedef enum log_category
+{
+    LOG_CATEGORY_CORE,
+    LOG_CATEGORY_PLATFORM,
+    LOG_CATEGORY_EVENT,
+    LOG_CATEGORY_INPUT,
+    LOG_CATEGORY_MEMORY,
+    LOG_CATEGORY_RENDERER,
+    LOG_CATEGORY_VULKAN,
+    LOG_CATEGORY_GAME,
+
+    LOG_CATEGORY_MAX
+} log_category;
+
+/**
+ * Compile-time maximum level per category, as a number matching log_level.
+ * Messages above it are stripped from the build. Override any of these on
+ * the compiler command line, e.g. -DLOG_COMPILE_LEVEL_VULKAN=2.
+ */
+#ifndef LOG_COMPILE_LEVEL_DEFAULT
+#if RCRELEASE == 1
+#define LOG_COMPILE_LEVEL_DEFAULT 3
+#else
+#define LOG_COMPILE_LEVEL_DEFAULT 5
+#endif
+#endif
+
+#ifndef LOG_COMPILE_LEVEL_CORE
+#define LOG_COMPILE_LEVEL_CORE LOG_COMPILE_LEVEL_DEFAULT
+#endif
+#ifndef LOG_COMPILE_LEVEL_PLATFORM
+#define LOG_COMPILE_LEVEL_PLATFORM LOG_COMPILE_LEVEL_DEFAULT
+#endif
+#ifndef LOG_COMPILE_LEVEL_EVENT
+#define LOG_COMPILE_LEVEL_EVENT LOG_COMPILE_LEVEL_DEFAULT
+#endif
+#ifndef LOG_COMPILE_LEVEL_INPUT
+#define LOG_COMPILE_LEVEL_INPUT LOG_COMPILE_LEVEL_DEFAULT
+#endif
+#ifndef LOG_COMPILE_LEVEL_MEMORY
+#define LOG_COMPILE_LEVEL_MEMORY LOG_COMPILE_LEVEL_DEFAULT
+#endif
+#ifndef LOG_COMPILE_LEVEL_RENDERER
+#define LOG_COMPILE_LEVEL_RENDERER LOG_COMPILE_LEVEL_DEFAULT
+#endif
+#ifndef LOG_COMPILE_LEVEL_VULKAN
+#define LOG_COMPILE_LEVEL_VULKAN LOG_COMPILE_LEVEL_DEFAULT
+#endif
+#ifndef LOG_COMPILE_LEVEL_GAME
+#define LOG_COMPILE_LEVEL_GAME LOG_COMPILE_LEVEL_DEFAULT
+#endif
+
+/**
+ * Per-call-site state for RCLOG_LIMITED. Counts are approximate when one
+ * call site is hit from several threads at once.
+ */
+typedef struct log_rate_limit
+{
+    f64 window_start;
+    u32 count;
+    u32 suppressed;
+} log_rate_limit;
+
+/** What a producer does when the log ring has no room for its message. */
+typedef enum log_full_policy
+{
+    /** Drop the message; the writer reports how many were lost. Never stalls the caller. */
+    LOG_FULL_POLICY_DROP = 0,
+    /** Wait a bounded time for the writer to make room, then drop. */
+    LOG_FULL_POLICY_BLOCK = 1
+} log_full_policy;
+
+/**
+ * Starts the background writer, which batches messages to the console and
+ * to console.log. Messages logged before this, or after shutdown_logging,
+ * are written synchronously to the console.
+ * @returns true on success; on failure logging stays synchronous.
+ */
 b8 initialize_logging();
+
+/**
+ * Writes out everything still queued and stops the writer thread. Other
+ * threads must have stopped logging by the time this is called.
+ */
 void shutdown_logging();
 
+/**
+ * Sets the policy for warnings and below when the ring is full. Errors and
+ * fatal messages always use LOG_FULL_POLICY_BLOCK. The default is LOG_FULL_POLICY_DROP.
+ * @param policy The policy to use.
+ */
+RCAPI void logger_set_full_policy(log_full_policy policy);
+
+/**
+ * Waits (bounded) until every message logged so far has been written out.
+ * Fatal messages do this automatically.
+ */
+RCAPI void logger_flush();
+
+/**
+ * Sets whether log_output_deferred hands formatting to the writer thread.
+ * Enabled by default; disable to format on the calling thread when a
+ * format string may not outlive the call (e.g. one from an unloaded module).
+ * @param enabled True to defer formatting.
+ */
+RCAPI void logger_set_deferred_formatting(b8 enabled);
+
+/**
+ * Formats a message on the calling thread and queues the text.
+ */
 RCAPI void log_output(log_level level, const char *message, ...);
 
+/**
+ * Queues only the format string pointer, level, timestamp and packed
+ * arguments; the writer thread formats the text later. Strings passed for
+ * %s are copied, but the format string itself must stay valid, so it should
+ * be a string literal. Used by RCLOG and RCWARN and below. Errors and
+ * fatal messages are formatted immediately.
+ */
+RCAPI void log_output_deferred(log_level level, const char *format, ...);
+
+/**
+ * Sets the most verbose level a category logs at runtime. Levels stripped at
+ * compile time cannot be turned back on. All categories start at LOG_LEVEL_TRACE.
+ * @param category The category to change.
+ * @param level The most verbose level to keep.
+ */
+RCAPI void log_category_set_level(log_category category, log_level level);
+
+/**
+ * @returns true if the category currently logs messages at the given level.
+ */
+RCAPI b8 log_category_enabled(log_category category, log_level level);
+
+/**
+ * Lets through at most max_per_second messages per second from one call
+ * site. When a new second starts after some were held back, logs how many
+ * were suppressed.
+ * @param limit The call site's state, zero-initialized.
+ * @param max_per_second The messages to allow per second.
+ * @param file The call site's file, for the suppression notice.
+ * @param line The call site's line, for the suppression notice.
+ * @returns true if this message should be logged.
+ */
+RCAPI b8 log_rate_limit_allow(log_rate_limit *limit, u32 max_per_second, const char *file, i32 line);
+
+/**
+ * Logs to a category, e.g. RCLOG(VULKAN, LOG_LEVEL_WARN, "..."). Compiles to
+ * nothing when the level is above LOG_COMPILE_LEVEL_<category>, and
+ * otherwise checks the runtime level before any argument is evaluated.
+ */
+#define RCLOG(category, level, message, ...)                                                                       \
+    do                                                                                                             \
+    {                                                                                                              \
+        if ((level) <= LOG_COMPILE_LEVEL_##category && log_category_enabled(LOG_CATEGORY_##category, level))   \
+        {                                                                                                          \
+            log_output_deferred(level, "" message, ##__VA_ARGS__);                                                 \
+        }                                                                                                          \
+    } while (0)
+
+/**
+ * Like RCLOG, but logs at most max_per_second messages per second from this
+ * call site. For call sites that can fire every frame or faster.
+ */
+#define RCLOG_LIMITED(category, level, max_per_second, message, ...)                                               \
+    do                                                                                                             \
+    {                                                                                                              \
+        static log_rate_limit rc_log_rate_limit;                                                                   \
+        if ((level) <= LOG_COMPILE_LEVEL_##category && log_category_enabled(LOG_CATEGORY_##category, level) &&  \
+            log_rate_limit_allow(&rc_log_rate_limit, max_per_second, __FILE__, __LINE__))                          \
+        {                                                                                                          \
+            log_output_deferred(level, "" message, ##__VA_ARGS__);                                                 \
+        }                                                                                                          \
+    } while (0)
+
 #define RCFATAL(message, ...) log_output(LOG_LEVEL_FATAL, message, ##__VA_ARGS__);
 
 #ifndef RCERROR
 #define RCERROR(message, ...) log_output(LOG_LEVEL_ERROR, message, ##__VA_ARGS__);
 #endif
 
+// Warnings and below defer formatting and go to the core category.
 #if LOG_WARN_ENABLED == 1
-#define RCWARN(message, ...) log_output(LOG_LEVEL_WARN, message, ##__VA_ARGS__);
+#define RCWARN(message, ...) RCLOG(CORE, LOG_LEVEL_WARN, message, ##__VA_ARGS__);
 #else
 // Do nothing if warning logs are disabled
 #define RCWARN(message, ...)
 #endif
 
 #if LOG_INFO_ENABLED == 1
-#define RCINFO(message, ...) log_output(LOG_LEVEL_INFO, message, ##__VA_ARGS__);
+#define RCINFO(message, ...) RCLOG(CORE, LOG_LEVEL_INFO, message, ##__VA_ARGS__);
 #else
 #define RCINFO(message, ...)
 #endif
 
 #if LOG_DEBUG_ENABLED == 1
-#define RCDEBUG(message, ...) log_output(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
+#define RCDEBUG(message, ...) RCLOG(CORE, LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
 #else
 #define RCDEBUG(message, ...)
 #endif
 
 #if LOG_TRACE_ENABLED == 1
-#define RCTRACE(message, ...) log_output(LOG_LEVEL_TRACE, message, ##__VA_ARGS__);
+#define RCTRACE(message, ...) RCLOG(CORE, LOG_LEVEL_TRACE, message, ##__VA_ARGS__);
 #else
 #define RCTRACE(message, ...)
 #endif
\ No newline at end of file
@@ -0,0 +1,923 @@
+#include "core/profiler.h"
+#include "core/clock.h"
+#include "core/rcmemory.h"
+#include "core/logger.h"
+#include "core/rcstring.h"
+#include "core/string_builder.h"
+#include "platform/filesystem.h"
+#include "platform/platform.h"
+
+#include <stdatomic.h>
+
+#if RCPROFILE_ENABLED
+
+#define PROFILER_EVENT_MASK (PROFILER_EVENTS_PER_THREAD - 1)
+#define PROFILER_HISTORY_FRAME_MASK (PROFILER_HISTORY_FRAMES - 1)
+#define PROFILER_HISTORY_ZONE_MASK (PROFILER_HISTORY_ZONES - 1)
+#define PROFILER_CAPTURE_PATH_MAX 256
+// Text buffered by the trace writer between file writes.
+#define PROFILER_CAPTURE_TEXT_SIZE (64 * 1024)
+// Longest zone name written to a trace; longer names are cut short.
+#define PROFILER_CAPTURE_NAME_MAX 256
+
+typedef union profiler_event
+{
+    struct
+    {
+        // The zone name for a begin, 0 for an end, or profiler_counted_end.
+        const char *name;
+        u64 timestamp;
+    };
+    // A counted end is followed by PROFILER_COUNTER_EVENTS events of counter deltas.
+    u64 data[2];
+} profiler_event;
+
+#define PROFILER_COUNTER_EVENTS ((PERF_COUNTER_COUNT + 1) / 2)
+
+// Marks the end of a counted zone. Compared by address only.
+static const char profiler_counted_end[] = "";
+
+// Counts at the start of a counted zone.
+typedef struct profiler_counter_start
+{
+    perf_counter_sample sample;
+    // false if the counts could not be read, which makes it a plain zone.
+    b8 valid;
+} profiler_counter_start;
+
+/**
+ * Single-producer single-consumer ring of one thread's zone events. The
+ * owning thread writes; profiler_frame_end reads.
+ */
+typedef struct profiler_thread_buffer
+{
+    profiler_event *events;
+    _Atomic(const char *) name;
+
+    _Atomic u64 head;
+    u8 head_padding[56];
+    _Atomic u64 tail;
+    u8 tail_padding[56];
+
+    // Owning thread only. Events needed to end the recorded zones that are still
+    // open; a begin always leaves room for these, so a recorded zone can always be closed.
+    u32 reserved_events;
+    // Owning thread only. Zones recorded and not yet ended.
+    u32 open_depth;
+    // Owning thread only. Zones dropped and not yet ended, so their ends are dropped too.
+    u32 skip_depth;
+
+    // Owning thread only. Open counted zones.
+    profiler_counter_start counter_stack[PROFILER_MAX_DEPTH];
+    u32 counter_depth;
+} profiler_thread_buffer;
+
+typedef struct profiler_open_zone
+{
+    u32 node;
+    u64 begin;
+} profiler_open_zone;
+
+// Zones of one thread that profiler_frame_end has seen begin but not end.
+typedef struct profiler_thread_stack
+{
+    profiler_open_zone zones[PROFILER_MAX_DEPTH];
+    const char *names[PROFILER_MAX_DEPTH];
+    u32 depth;
+    // Begins past PROFILER_MAX_DEPTH, whose ends are ignored.
+    u32 overflow;
+} profiler_thread_stack;
+
+// A closed zone, kept for trace captures. Times are in cycles.
+typedef struct profiler_zone_record
+{
+    const char *name;
+    u64 begin;
+    u64 end;
+    u16 thread_index;
+    u16 depth;
+} profiler_zone_record;
+
+// A frame of the timeline; its zones are history indices [first_zone, zone_end).
+typedef struct profiler_frame_record
+{
+    u64 number;
+    u64 begin;
+    u64 end;
+    u64 first_zone;
+    u64 zone_end;
+} profiler_frame_record;
+
+typedef struct profiler_state
+{
+    profiler_thread_buffer threads[PROFILER_MAX_THREADS];
+    _Atomic u32 thread_count;
+    _Atomic u64 dropped;
+
+    // profiler_frame_end only.
+    profiler_thread_stack stacks[PROFILER_MAX_THREADS];
+    // The tree being built and the last completed one.
+    profiler_node *nodes[2];
+    u32 node_count[2];
+    u32 first_root[2];
+    u32 building;
+
+    // Read by every thread starting a counted zone.
+    _Atomic b8 counters_enabled;
+    // Counts of the profiler_frame_end thread at the last frame end, and over the last frame.
+    perf_counter_sample frame_counter_start;
+    perf_counter_values frame_counters;
+
+    // profiler_frame_end only. Rings of the zones closed in recent frames, and those frames.
+    profiler_zone_record *history_zones;
+    u64 history_zone_count;
+    profiler_frame_record history_frames[PROFILER_HISTORY_FRAMES];
+    u64 history_frame_count;
+    u64 frame_begin;
+
+    // A requested capture. Set by profiler_capture_trace, taken by profiler_frame_end.
+    b8 capture_requested;
+    u32 capture_request_frames;
+    char capture_path[PROFILER_CAPTURE_PATH_MAX];
+    // Set from the request until the writer is done; the snapshot below belongs to the writer meanwhile.
+    _Atomic b8 capture_busy;
+    platform_thread capture_thread;
+
+    // The snapshot being written.
+    profiler_zone_record *capture_zones;
+    u64 capture_zone_count;
+    profiler_frame_record capture_frames[PROFILER_HISTORY_FRAMES];
+    u32 capture_frame_count;
+    const char *capture_thread_names[PROFILER_MAX_THREADS];
+    u32 capture_thread_count;
+    char *capture_text;
+} profiler_state;
+
+static b8 initialized = false;
+static profiler_state *state_ptr = 0;
+
+// 1-based index into state_ptr->threads; 0 until the thread first records, PROFILER_MAX_THREADS + 1 if there was no room.
+static RCTHREAD_LOCAL u32 thread_slot = 0;
+
+b8 profiler_initialize()
+{
+    if (initialized)
+    {
+        return false;
+    }
+
+    state_ptr = rcallocate(sizeof(profiler_state), MEMORY_TAG_PROFILER);
+    for (u32 i = 0; i < PROFILER_MAX_THREADS; ++i)
+    {
+        state_ptr->threads[i].events = rcallocate(sizeof(profiler_event) * PROFILER_EVENTS_PER_THREAD, MEMORY_TAG_PROFILER);
+    }
+    for (u32 i = 0; i < 2; ++i)
+    {
+        state_ptr->nodes[i] = rcallocate(sizeof(profiler_node) * PROFILER_MAX_NODES, MEMORY_TAG_PROFILER);
+        state_ptr->first_root[i] = PROFILER_INVALID_NODE;
+    }
+    state_ptr->history_zones = rcallocate(sizeof(profiler_zone_record) * PROFILER_HISTORY_ZONES, MEMORY_TAG_PROFILER);
+    state_ptr->capture_zones = rcallocate(sizeof(profiler_zone_record) * PROFILER_HISTORY_ZONES, MEMORY_TAG_PROFILER);
+    state_ptr->capture_text = rcallocate(PROFILER_CAPTURE_TEXT_SIZE, MEMORY_TAG_PROFILER);
+    state_ptr->frame_begin = platform_read_cycle_counter();
+
+    initialized = true;
+    return true;
+}
+
+void profiler_shutdown()
+{
+    if (!initialized)
+    {
+        return;
+    }
+
+    initialized = false;
+
+    // Let a capture in progress finish writing.
+    platform_thread_join(&state_ptr->capture_thread);
+
+    if (atomic_load_explicit(&state_ptr->counters_enabled, memory_order_relaxed))
+    {
+        perf_counters_thread_close();
+    }
+
+    for (u32 i = 0; i < PROFILER_MAX_THREADS; ++i)
+    {
+        rcfree(state_ptr->threads[i].events, sizeof(profiler_event) * PROFILER_EVENTS_PER_THREAD, MEMORY_TAG_PROFILER);
+    }
+    for (u32 i = 0; i < 2; ++i)
+    {
+        rcfree(state_ptr->nodes[i], sizeof(profiler_node) * PROFILER_MAX_NODES, MEMORY_TAG_PROFILER);
+    }
+    rcfree(state_ptr->history_zones, sizeof(profiler_zone_record) * PROFILER_HISTORY_ZONES, MEMORY_TAG_PROFILER);
+    rcfree(state_ptr->capture_zones, sizeof(profiler_zone_record) * PROFILER_HISTORY_ZONES, MEMORY_TAG_PROFILER);
+    rcfree(state_ptr->capture_text, PROFILER_CAPTURE_TEXT_SIZE, MEMORY_TAG_PROFILER);
+    rcfree(state_ptr, sizeof(profiler_state), MEMORY_TAG_PROFILER);
+    state_ptr = 0;
+}
+
+static profiler_thread_buffer *get_thread_buffer()
+{
+    if (thread_slot == 0)
+    {
+        u32 index = atomic_fetch_add_explicit(&state_ptr->thread_count, 1, memory_order_relaxed);
+        thread_slot = index < PROFILER_MAX_THREADS ? index + 1 : PROFILER_MAX_THREADS + 1;
+    }
+
+    return thread_slot <= PROFILER_MAX_THREADS ? &state_ptr->threads[thread_slot - 1] : 0;
+}
+
+void profiler_set_thread_name(const char *name)
+{
+    if (!initialized)
+    {
+        return;
+    }
+
+    profiler_thread_buffer *buffer = get_thread_buffer();
+    if (buffer)
+    {
+        atomic_store_explicit(&buffer->name, name, memory_order_relaxed);
+    }
+}
+
+void profiler_zone_begin(const char *name)
+{
+    if (!initialized)
+    {
+        return;
+    }
+
+    profiler_thread_buffer *buffer = get_thread_buffer();
+    if (!buffer)
+    {
+        atomic_fetch_add_explicit(&state_ptr->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    u64 head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    u64 tail = atomic_load_explicit(&buffer->tail, memory_order_acquire);
+    u64 free_events = PROFILER_EVENTS_PER_THREAD - (head - tail);
+    if (buffer->skip_depth || free_events < buffer->reserved_events + 2)
+    {
+        buffer->skip_depth++;
+        atomic_fetch_add_explicit(&state_ptr->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    profiler_event *event = &buffer->events[head & PROFILER_EVENT_MASK];
+    event->name = name;
+    event->timestamp = platform_read_cycle_counter();
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+    buffer->reserved_events++;
+    buffer->open_depth++;
+}
+
+void profiler_zone_end()
+{
+    if (!initialized)
+    {
+        return;
+    }
+
+    u64 timestamp = platform_read_cycle_counter();
+    profiler_thread_buffer *buffer = get_thread_buffer();
+    if (!buffer)
+    {
+        return;
+    }
+    if (buffer->skip_depth)
+    {
+        buffer->skip_depth--;
+        return;
+    }
+    if (buffer->open_depth == 0)
+    {
+        // Unmatched end.
+        return;
+    }
+
+    u64 head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    profiler_event *event = &buffer->events[head & PROFILER_EVENT_MASK];
+    event->name = 0;
+    event->timestamp = timestamp;
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+    buffer->reserved_events--;
+    buffer->open_depth--;
+}
+
+void profiler_zone_begin_counters(const char *name)
+{
+    if (!initialized)
+    {
+        return;
+    }
+
+    profiler_thread_buffer *buffer = get_thread_buffer();
+    if (!buffer)
+    {
+        atomic_fetch_add_explicit(&state_ptr->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    // Room for the begin, and for a counted end if the zone turns out counted.
+    u64 head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    u64 tail = atomic_load_explicit(&buffer->tail, memory_order_acquire);
+    u64 free_events = PROFILER_EVENTS_PER_THREAD - (head - tail);
+    if (buffer->skip_depth || buffer->counter_depth >= PROFILER_MAX_DEPTH ||
+        free_events < buffer->reserved_events + 2 + PROFILER_COUNTER_EVENTS)
+    {
+        buffer->skip_depth++;
+        atomic_fetch_add_explicit(&state_ptr->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    // Counters first, so reading them is not part of the zone's time.
+    profiler_counter_start *start = &buffer->counter_stack[buffer->counter_depth++];
+    start->valid = atomic_load_explicit(&state_ptr->counters_enabled, memory_order_relaxed) &&
+                   perf_counters_thread_open() &&
+                   perf_counters_read(&start->sample);
+
+    profiler_event *event = &buffer->events[head & PROFILER_EVENT_MASK];
+    event->name = name;
+    event->timestamp = platform_read_cycle_counter();
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+    buffer->reserved_events += start->valid ? 1 + PROFILER_COUNTER_EVENTS : 1;
+    buffer->open_depth++;
+}
+
+void profiler_zone_end_counters()
+{
+    if (!initialized)
+    {
+        return;
+    }
+
+    u64 timestamp = platform_read_cycle_counter();
+    profiler_thread_buffer *buffer = get_thread_buffer();
+    if (!buffer)
+    {
+        return;
+    }
+    if (buffer->skip_depth)
+    {
+        buffer->skip_depth--;
+        return;
+    }
+    if (buffer->open_depth == 0 || buffer->counter_depth == 0)
+    {
+        // Unmatched end.
+        return;
+    }
+
+    profiler_counter_start *start = &buffer->counter_stack[--buffer->counter_depth];
+    perf_counter_sample end;
+    b8 counted = start->valid && perf_counters_read(&end);
+
+    u64 head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    profiler_event *event = &buffer->events[head & PROFILER_EVENT_MASK];
+    event->name = counted ? profiler_counted_end : 0;
+    event->timestamp = timestamp;
+    u64 written = 1;
+    if (counted)
+    {
+        perf_counter_values delta;
+        perf_counters_delta(&start->sample, &end, &delta);
+        for (u32 i = 0; i < PERF_COUNTER_COUNT; ++i)
+        {
+            buffer->events[(head + 1 + i / 2) & PROFILER_EVENT_MASK].data[i % 2] = delta.values[i];
+        }
+        written += PROFILER_COUNTER_EVENTS;
+    }
+    atomic_store_explicit(&buffer->head, head + written, memory_order_release);
+    buffer->reserved_events -= start->valid ? 1 + PROFILER_COUNTER_EVENTS : 1;
+    buffer->open_depth--;
+}
+
+/**
+ * Finds the child of parent with the given name in the tree being built, adding it if needed.
+ * @returns The node index, or PROFILER_INVALID_NODE if the tree is full.
+ */
+static u32 find_or_add_node(u32 parent, const char *name, u16 thread_index, u16 depth)
+{
+    u32 tree = state_ptr->building;
+    profiler_node *nodes = state_ptr->nodes[tree];
+
+    u32 *link = parent == PROFILER_INVALID_NODE ? &state_ptr->first_root[tree] : &nodes[parent].first_child;
+    while (*link != PROFILER_INVALID_NODE)
+    {
+        profiler_node *node = &nodes[*link];
+        if (node->thread_index == thread_index && (node->name == name || strings_equal(node->name, name)))
+        {
+            return *link;
+        }
+        link = &node->next_sibling;
+    }
+
+    if (state_ptr->node_count[tree] >= PROFILER_MAX_NODES)
+    {
+        atomic_fetch_add_explicit(&state_ptr->dropped, 1, memory_order_relaxed);
+        return PROFILER_INVALID_NODE;
+    }
+
+    u32 index = state_ptr->node_count[tree]++;
+    profiler_node *node = &nodes[index];
+    node->name = name;
+    node->parent = parent;
+    node->first_child = PROFILER_INVALID_NODE;
+    node->next_sibling = PROFILER_INVALID_NODE;
+    node->call_count = 0;
+    node->depth = depth;
+    node->thread_index = thread_index;
+    node->total_ns = 0;
+    node->self_ns = 0;
+    rczero_memory(&node->counters, sizeof(perf_counter_values));
+    *link = index;
+    return index;
+}
+
+static void collect_thread(u32 thread_index)
+{
+    profiler_thread_buffer *buffer = &state_ptr->threads[thread_index];
+    profiler_thread_stack *stack = &state_ptr->stacks[thread_index];
+    profiler_node *nodes = state_ptr->nodes[state_ptr->building];
+
+    u64 head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+    u64 tail = atomic_load_explicit(&buffer->tail, memory_order_relaxed);
+    for (; tail != head; ++tail)
+    {
+        const profiler_event *event = &buffer->events[tail & PROFILER_EVENT_MASK];
+        if (event->name && event->name != profiler_counted_end)
+        {
+            if (stack->depth >= PROFILER_MAX_DEPTH)
+            {
+                stack->overflow++;
+                atomic_fetch_add_explicit(&state_ptr->dropped, 1, memory_order_relaxed);
+                continue;
+            }
+
+            u32 parent = stack->depth ? stack->zones[stack->depth - 1].node : PROFILER_INVALID_NODE;
+            // Below a node that did not fit, nothing fits.
+            u32 node = stack->depth && parent == PROFILER_INVALID_NODE
+                           ? PROFILER_INVALID_NODE
+                           : find_or_add_node(parent, event->name, (u16)thread_index, (u16)stack->depth);
+            stack->names[stack->depth] = event->name;
+            stack->zones[stack->depth].node = node;
+            stack->zones[stack->depth].begin = event->timestamp;
+            stack->depth++;
+        }
+        else
+        {
+            // A counted end is followed by its counter deltas.
+            b8 counted = event->name == profiler_counted_end;
+            u64 counters_at = tail + 1;
+            if (counted)
+            {
+                tail += PROFILER_COUNTER_EVENTS;
+            }
+
+            if (stack->overflow)
+            {
+                stack->overflow--;
+                continue;
+            }
+            if (stack->depth == 0)
+            {
+                continue;
+            }
+
+            profiler_open_zone *zone = &stack->zones[--stack->depth];
+            if (zone->node != PROFILER_INVALID_NODE)
+            {
+                profiler_node *node = &nodes[zone->node];
+                // Accumulated in cycles here, converted once the frame is complete.
+                node->total_ns += event->timestamp - zone->begin;
+                node->call_count++;
+                for (u32 i = 0; counted && i < PERF_COUNTER_COUNT; ++i)
+                {
+                    node->counters.values[i] += buffer->events[(counters_at + i / 2) & PROFILER_EVENT_MASK].data[i % 2];
+                }
+            }
+
+            profiler_zone_record *record = &state_ptr->history_zones[state_ptr->history_zone_count++ & PROFILER_HISTORY_ZONE_MASK];
+            record->name = stack->names[stack->depth];
+            record->begin = zone->begin;
+            record->end = event->timestamp;
+            record->thread_index = (u16)thread_index;
+            record->depth = (u16)stack->depth;
+        }
+    }
+
+    atomic_store_explicit(&buffer->tail, tail, memory_order_release);
+}
+
+static void append_json_string(string_builder *builder, const char *str)
+{
+    string_builder_append_char(builder, '"');
+    for (u32 i = 0; str[i] && i < PROFILER_CAPTURE_NAME_MAX; ++i)
+    {
+        char c = str[i];
+        if (c == '"' || c == '\\')
+        {
+            string_builder_append_char(builder, '\\');
+            string_builder_append_char(builder, c);
+        }
+        else if ((u8)c < 0x20)
+        {
+            string_builder_appendf(builder, "\\u%04x", (u32)(u8)c);
+        }
+        else
+        {
+            string_builder_append_char(builder, c);
+        }
+    }
+    string_builder_append_char(builder, '"');
+}
+
+// Writes out the builder's text once it is nearly full, or always if force is set.
+static b8 flush_trace_text(file_handle *file, string_builder *builder, b8 force)
+{
+    if (!force && builder->length < builder->capacity - PROFILER_CAPTURE_NAME_MAX * 2 - 256)
+    {
+        return true;
+    }
+
+    u64 written = 0;
+    b8 result = filesystem_write(file, builder->length, builder->buffer, &written);
+    string_builder_clear(builder);
+    return result;
+}
+
+// Microseconds from base to time, both in cycles; times before base are clamped to it.
+static f64 trace_time_us(u64 base, u64 time)
+{
+    return time > base ? (f64)clock_cycles_to_ns(time - base) / 1000.0 : 0.0;
+}
+
+static u32 write_trace(void *params)
+{
+    profiler_state *state = params;
+
+    file_handle file;
+    if (!filesystem_open(state->capture_path, FILE_MODE_WRITE, false, &file))
+    {
+        RCERROR("profiler_capture_trace - could not open '%s' for writing.", state->capture_path);
+        atomic_store_explicit(&state->capture_busy, false, memory_order_release);
+        return 1;
+    }
+
+    string_builder builder;
+    string_builder_create(PROFILER_CAPTURE_TEXT_SIZE, state->capture_text, &builder);
+    b8 result = true;
+
+    // Zones go on a track per thread, frames on a track of their own after them.
+    u32 frame_track = PROFILER_MAX_THREADS;
+    string_builder_append(&builder, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    string_builder_appendf(&builder, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"frames\"}}", frame_track);
+    for (u32 i = 0; i < state->capture_thread_count; ++i)
+    {
+        string_builder_appendf(&builder, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", i);
+        if (state->capture_thread_names[i])
+        {
+            append_json_string(&builder, state->capture_thread_names[i]);
+        }
+        else
+        {
+            string_builder_appendf(&builder, "\"thread %u\"", i);
+        }
+        string_builder_append(&builder, "}}");
+    }
+
+    u64 base = state->capture_frame_count ? state->capture_frames[0].begin : 0;
+    for (u32 i = 0; i < state->capture_frame_count && result; ++i)
+    {
+        const profiler_frame_record *frame = &state->capture_frames[i];
+        f64 begin = trace_time_us(base, frame->begin);
+        string_builder_appendf(
+            &builder,
+            ",\n{\"name\":\"frame %llu\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            frame->number,
+            frame_track,
+            begin,
+            trace_time_us(base, frame->end) - begin);
+        result = flush_trace_text(&file, &builder, false);
+    }
+
+    for (u64 i = 0; i < state->capture_zone_count && result; ++i)
+    {
+        const profiler_zone_record *zone = &state->capture_zones[i];
+        f64 begin = trace_time_us(base, zone->begin);
+        string_builder_append(&builder, ",\n{\"name\":");
+        append_json_string(&builder, zone->name);
+        string_builder_appendf(
+            &builder,
+            ",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}",
+            (u32)zone->thread_index,
+            begin,
+            trace_time_us(base, zone->end) - begin,
+            (u32)zone->depth);
+        result = flush_trace_text(&file, &builder, false);
+    }
+
+    string_builder_append(&builder, "\n]}\n");
+    result = result && flush_trace_text(&file, &builder, true);
+    filesystem_close(&file);
+
+    if (result)
+    {
+        RCINFO("Wrote a %u frame profiler trace to '%s'.", state->capture_frame_count, state->capture_path);
+    }
+    else
+    {
+        RCERROR("profiler_capture_trace - failed writing to '%s'.", state->capture_path);
+    }
+    atomic_store_explicit(&state->capture_busy, false, memory_order_release);
+    return result ? 0 : 1;
+}
+
+// Copies the requested frames of the timeline for the writer and starts it.
+static void take_capture(u32 thread_count)
+{
+    state_ptr->capture_requested = false;
+
+    // The previous writer has finished, but its thread is not yet released.
+    platform_thread_join(&state_ptr->capture_thread);
+
+    u64 frames = state_ptr->capture_request_frames ? state_ptr->capture_request_frames : PROFILER_HISTORY_FRAMES;
+    if (frames > PROFILER_HISTORY_FRAMES)
+    {
+        frames = PROFILER_HISTORY_FRAMES;
+    }
+    if (frames > state_ptr->history_frame_count)
+    {
+        frames = state_ptr->history_frame_count;
+    }
+
+    // Skip frames whose zones have already been overwritten.
+    u64 first = state_ptr->history_frame_count - frames;
+    u64 oldest_zone = state_ptr->history_zone_count > PROFILER_HISTORY_ZONES ? state_ptr->history_zone_count - PROFILER_HISTORY_ZONES : 0;
+    while (first < state_ptr->history_frame_count && state_ptr->history_frames[first & PROFILER_HISTORY_FRAME_MASK].first_zone < oldest_zone)
+    {
+        first++;
+    }
+
+    state_ptr->capture_frame_count = 0;
+    for (u64 i = first; i < state_ptr->history_frame_count; ++i)
+    {
+        state_ptr->capture_frames[state_ptr->capture_frame_count++] = state_ptr->history_frames[i & PROFILER_HISTORY_FRAME_MASK];
+    }
+
+    u64 zone_begin = state_ptr->capture_frame_count ? state_ptr->capture_frames[0].first_zone : state_ptr->history_zone_count;
+    u64 zone_count = state_ptr->history_zone_count - zone_begin;
+    u64 start = zone_begin & PROFILER_HISTORY_ZONE_MASK;
+    u64 first_part = zone_count < PROFILER_HISTORY_ZONES - start ? zone_count : PROFILER_HISTORY_ZONES - start;
+    rccopy_memory(state_ptr->capture_zones, &state_ptr->history_zones[start], first_part * sizeof(profiler_zone_record));
+    rccopy_memory(&state_ptr->capture_zones[first_part], state_ptr->history_zones, (zone_count - first_part) * sizeof(profiler_zone_record));
+    state_ptr->capture_zone_count = zone_count;
+
+    state_ptr->capture_thread_count = thread_count;
+    for (u32 i = 0; i < thread_count; ++i)
+    {
+        state_ptr->capture_thread_names[i] = atomic_load_explicit(&state_ptr->threads[i].name, memory_order_relaxed);
+    }
+
+    if (!platform_thread_create(write_trace, state_ptr, &state_ptr->capture_thread))
+    {
+        RCERROR("profiler_capture_trace - could not start the writer thread.");
+        atomic_store_explicit(&state_ptr->capture_busy, false, memory_order_release);
+    }
+}
+
+void profiler_frame_end()
+{
+    if (!initialized)
+    {
+        return;
+    }
+
+    u64 now = platform_read_cycle_counter();
+    u32 thread_count = atomic_load_explicit(&state_ptr->thread_count, memory_order_acquire);
+    if (thread_count > PROFILER_MAX_THREADS)
+    {
+        thread_count = PROFILER_MAX_THREADS;
+    }
+
+    for (u32 i = 0; i < thread_count; ++i)
+    {
+        collect_thread(i);
+    }
+
+    if (atomic_load_explicit(&state_ptr->counters_enabled, memory_order_relaxed))
+    {
+        perf_counter_sample sample;
+        if (perf_counters_read(&sample))
+        {
+            perf_counters_delta(&state_ptr->frame_counter_start, &sample, &state_ptr->frame_counters);
+            state_ptr->frame_counter_start = sample;
+        }
+    }
+
+    profiler_frame_record *frame = &state_ptr->history_frames[state_ptr->history_frame_count & PROFILER_HISTORY_FRAME_MASK];
+    frame->number = state_ptr->history_frame_count;
+    frame->begin = state_ptr->frame_begin;
+    frame->end = now;
+    frame->first_zone = state_ptr->history_frame_count ? state_ptr->history_frames[(state_ptr->history_frame_count - 1) & PROFILER_HISTORY_FRAME_MASK].zone_end : 0;
+    frame->zone_end = state_ptr->history_zone_count;
+    state_ptr->history_frame_count++;
+    state_ptr->frame_begin = now;
+
+    if (state_ptr->capture_requested)
+    {
+        take_capture(thread_count);
+    }
+
+    // Convert to nanoseconds and work out self times. Parents come before their children.
+    u32 tree = state_ptr->building;
+    profiler_node *nodes = state_ptr->nodes[tree];
+    u32 count = state_ptr->node_count[tree];
+    for (u32 i = 0; i < count; ++i)
+    {
+        nodes[i].total_ns = clock_cycles_to_ns(nodes[i].total_ns);
+        nodes[i].self_ns = nodes[i].total_ns;
+    }
+    for (u32 i = 0; i < count; ++i)
+    {
+        u32 parent = nodes[i].parent;
+        if (parent != PROFILER_INVALID_NODE)
+        {
+            // A child can outweigh a parent that is still open, so clamp.
+            profiler_node *p = &nodes[parent];
+            p->self_ns = p->self_ns > nodes[i].total_ns ? p->self_ns - nodes[i].total_ns : 0;
+        }
+    }
+
+    // Start the next tree, carrying over the zones that are still open.
+    tree ^= 1;
+    state_ptr->building = tree;
+    state_ptr->node_count[tree] = 0;
+    state_ptr->first_root[tree] = PROFILER_INVALID_NODE;
+    for (u32 t = 0; t < thread_count; ++t)
+    {
+        profiler_thread_stack *stack = &state_ptr->stacks[t];
+        u32 parent = PROFILER_INVALID_NODE;
+        for (u32 d = 0; d < stack->depth; ++d)
+        {
+            u32 node = d && parent == PROFILER_INVALID_NODE ? PROFILER_INVALID_NODE : find_or_add_node(parent, stack->names[d], (u16)t, (u16)d);
+            stack->zones[d].node = node;
+            parent = node;
+        }
+    }
+}
+
+const profiler_node *profiler_last_frame(u32 *out_count)
+{
+    if (!initialized)
+    {
+        *out_count = 0;
+        return 0;
+    }
+
+    u32 tree = state_ptr->building ^ 1;
+    *out_count = state_ptr->node_count[tree];
+    return state_ptr->nodes[tree];
+}
+
+u64 profiler_dropped_zones()
+{
+    return initialized ? atomic_load_explicit(&state_ptr->dropped, memory_order_relaxed) : 0;
+}
+
+b8 profiler_capture_trace(const char *path, u32 frame_count)
+{
+    if (!initialized || atomic_load_explicit(&state_ptr->capture_busy, memory_order_acquire))
+    {
+        return false;
+    }
+
+    if (!path)
+    {
+        path = "profile_trace.json";
+    }
+    u64 length = string_length(path);
+    if (length >= PROFILER_CAPTURE_PATH_MAX)
+    {
+        RCERROR("profiler_capture_trace - path is too long.");
+        return false;
+    }
+
+    rccopy_memory(state_ptr->capture_path, path, length + 1);
+    state_ptr->capture_request_frames = frame_count;
+    state_ptr->capture_requested = true;
+    atomic_store_explicit(&state_ptr->capture_busy, true, memory_order_relaxed);
+    return true;
+}
+
+b8 profiler_capture_pending()
+{
+    return initialized && atomic_load_explicit(&state_ptr->capture_busy, memory_order_acquire);
+}
+
+b8 profiler_enable_counters(b8 enabled)
+{
+    if (!initialized)
+    {
+        return false;
+    }
+
+    if (!enabled)
+    {
+        atomic_store_explicit(&state_ptr->counters_enabled, false, memory_order_relaxed);
+        return false;
+    }
+
+    if (!perf_counters_thread_open() || !perf_counters_read(&state_ptr->frame_counter_start))
+    {
+        return false;
+    }
+
+    rczero_memory(&state_ptr->frame_counters, sizeof(perf_counter_values));
+    atomic_store_explicit(&state_ptr->counters_enabled, true, memory_order_relaxed);
+    return true;
+}
+
+b8 profiler_frame_counters(perf_counter_values *out_values)
+{
+    if (!initialized || !atomic_load_explicit(&state_ptr->counters_enabled, memory_order_relaxed))
+    {
+        return false;
+    }
+
+    *out_values = state_ptr->frame_counters;
+    return true;
+}
+
+#else
+
+// Profiling is compiled out: no buffers are allocated and every call returns at once.
+
+b8 profiler_initialize()
+{
+    return false;
+}
+
+void profiler_shutdown()
+{
+}
+
+void profiler_set_thread_name(const char *name)
+{
+}
+
+void profiler_zone_begin(const char *name)
+{
+}
+
+void profiler_zone_end()
+{
+}
+
+void profiler_zone_begin_counters(const char *name)
+{
+}
+
+void profiler_zone_end_counters()
+{
+}
+
+b8 profiler_enable_counters(b8 enabled)
+{
+    return false;
+}
+
+b8 profiler_frame_counters(perf_counter_values *out_values)
+{
+    return false;
+}
+
+void profiler_frame_end()
+{
+}
+
+const profiler_node *profiler_last_frame(u32 *out_count)
+{
+    *out_count = 0;
+    return 0;
+}
+
+u64 profiler_dropped_zones()
+{
+    return 0;
+}
+
+b8 profiler_capture_trace(const char *path, u32 frame_count)
+{
+    return false;
+}
+
+b8 profiler_capture_pending()
+{
+    return false;
+}
+
+#endif // RCPROFILE_ENABLED
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/perf_counters.h"
+
+/**
+ * Hierarchical CPU profiler.
+ *
+ * Zones are marked with RC_PROFILE_SCOPE("name") (ends with the enclosing
+ * block) or RC_PROFILE_BEGIN/RC_PROFILE_END pairs. Each thread records into
+ * its own lock-free buffer, timestamped with platform_read_cycle_counter.
+ * Once per frame, profiler_frame_end collects every thread's zones into a
+ * call tree with total and self times, readable with profiler_last_frame.
+ *
+ * The zones of the last PROFILER_HISTORY_FRAMES frames are also kept as a
+ * timeline, which profiler_capture_trace writes out in the Chrome trace event
+ * format (chrome://tracing, ui.perfetto.dev) on a background thread.
+ *
+ * With profiler_enable_counters, whole frames and the zones marked with the
+ * *_COUNTERS macros also collect hardware counters (instructions, cycles,
+ * cache and branch misses) where the platform provides them. Each counted
+ * zone costs two counter reads, which are system calls on Linux, so count
+ * subsystems rather than small, hot functions.
+ *
+ * Zone names must be string literals, or otherwise outlive the profiler.
+ * Everything compiles out when RCPROFILE_ENABLED is 0, which is the default
+ * for release builds.
+ */
+
+#ifndef RCPROFILE_ENABLED
+#if RCRELEASE == 1
+#define RCPROFILE_ENABLED 0
+#else
+#define RCPROFILE_ENABLED 1
+#endif
+#endif
+
+#define PROFILER_MAX_THREADS 16
+// Events one thread can record between two profiler_frame_end calls. Must be a power of 2.
+#define PROFILER_EVENTS_PER_THREAD 8192
+#define PROFILER_MAX_NODES 4096
+#define PROFILER_MAX_DEPTH 64
+#define PROFILER_INVALID_NODE 0xFFFFFFFFu
+// Frames of timeline kept for trace captures, and the zones kept across them. Both must be powers of 2.
+#define PROFILER_HISTORY_FRAMES 128
+#define PROFILER_HISTORY_ZONES 32768
+
+/**
+ * One zone in a frame's call tree. Calls of the same zone under the same
+ * parent are merged into one node.
+ */
+typedef struct profiler_node
+{
+    const char *name;
+    u32 parent;
+    u32 first_child;
+    u32 next_sibling;
+    u32 call_count;
+    u16 depth;
+    u16 thread_index;
+    u64 total_ns;
+    // total_ns minus the total of the children.
+    u64 self_ns;
+    // Hardware counts summed over the node's counted calls, including their children. Zero for uncounted zones.
+    perf_counter_values counters;
+} profiler_node;
+
+/**
+ * Allocates the per-thread buffers. Zones recorded before this are ignored.
+ * @returns true on success; false when profiling is compiled out, in which case nothing is allocated.
+ */
+RCAPI b8 profiler_initialize();
+
+RCAPI void profiler_shutdown();
+
+/**
+ * Names the calling thread in trace captures. Threads are otherwise named by index.
+ * @param name The thread name; must outlive the profiler.
+ */
+RCAPI void profiler_set_thread_name(const char *name);
+
+/**
+ * Opens a zone on the calling thread. Prefer the RC_PROFILE_* macros.
+ * @param name The zone name; must outlive the profiler.
+ */
+RCAPI void profiler_zone_begin(const char *name);
+
+/**
+ * Closes the calling thread's innermost open zone.
+ */
+RCAPI void profiler_zone_end();
+
+/**
+ * Opens a zone that also collects hardware counters, when they are enabled
+ * and available; otherwise it is a plain zone. Must be closed with
+ * profiler_zone_end_counters.
+ * @param name The zone name; must outlive the profiler.
+ */
+RCAPI void profiler_zone_begin_counters(const char *name);
+
+/**
+ * Closes the calling thread's innermost open zone, which must have been opened with profiler_zone_begin_counters.
+ */
+RCAPI void profiler_zone_end_counters();
+
+/**
+ * Turns hardware counters on or off for frames and counted zones. Opens the
+ * counters for the calling thread, which should be the one calling
+ * profiler_frame_end; other threads open theirs on their first counted zone.
+ * @param enabled Whether to collect counters.
+ * @returns true if counters are now being collected; false if they are off or unavailable.
+ */
+RCAPI b8 profiler_enable_counters(b8 enabled);
+
+/**
+ * Gets the hardware counts of the thread calling profiler_frame_end over the last frame.
+ * @param out_values Receives the counts.
+ * @returns false if counters are not being collected.
+ */
+RCAPI b8 profiler_frame_counters(perf_counter_values *out_values);
+
+/**
+ * Collects the zones every thread has closed since the last call and
+ * builds them into the frame's call tree. Call once per frame, from one thread.
+ */
+RCAPI void profiler_frame_end();
+
+/**
+ * Gets the call tree of the last completed frame. Roots have parent
+ * PROFILER_INVALID_NODE; a parent always comes before its children.
+ * @param out_count Receives the number of nodes.
+ * @returns The nodes, valid until the next profiler_frame_end.
+ */
+RCAPI const profiler_node *profiler_last_frame(u32 *out_count);
+
+/**
+ * @returns The number of zones dropped because a thread's buffer was full or
+ * it had too many threads or nesting levels.
+ */
+RCAPI u64 profiler_dropped_zones();
+
+/**
+ * Requests a trace of the last frames. The timeline is copied at the next
+ * profiler_frame_end and written to disk on a background thread, so the
+ * frame is not held up by the file. Call from the thread that calls
+ * profiler_frame_end.
+ * @param path The file to write; 0 for "profile_trace.json".
+ * @param frame_count The number of frames to capture, up to PROFILER_HISTORY_FRAMES; 0 for all that are kept.
+ * @returns true if the capture was queued; false if one is still being written.
+ */
+RCAPI b8 profiler_capture_trace(const char *path, u32 frame_count);
+
+/**
+ * @returns true while a requested trace has not finished writing.
+ */
+RCAPI b8 profiler_capture_pending();
+
+RCINLINE void profiler_scope_end(const char **name)
+{
+    (void)name;
+    profiler_zone_end();
+}
+
+RCINLINE void profiler_scope_end_counters(const char **name)
+{
+    (void)name;
+    profiler_zone_end_counters();
+}
+
+#define RC_PROFILE_CONCAT_INNER(a, b) a##b
+#define RC_PROFILE_CONCAT(a, b) RC_PROFILE_CONCAT_INNER(a, b)
+
+#if RCPROFILE_ENABLED
+#define RC_PROFILE_BEGIN(name) profiler_zone_begin(name)
+#define RC_PROFILE_END() profiler_zone_end()
+#define RC_PROFILE_FRAME_END() profiler_frame_end()
+#define RC_PROFILE_BEGIN_COUNTERS(name) profiler_zone_begin_counters(name)
+#define RC_PROFILE_END_COUNTERS() profiler_zone_end_counters()
+#if defined(__clang__) || defined(__GNUC__)
+// Closes the zone when the enclosing block exits, including through return and break.
+#define RC_PROFILE_SCOPE(name)                                                                                     \
+    const char *RC_PROFILE_CONCAT(rc_profile_scope_, __LINE__) __attribute__((cleanup(profiler_scope_end), unused)) = \
+        (profiler_zone_begin(name), name)
+#define RC_PROFILE_SCOPE_COUNTERS(name)                                                                                        \
+    const char *RC_PROFILE_CONCAT(rc_profile_scope_, __LINE__) __attribute__((cleanup(profiler_scope_end_counters), unused)) = \
+        (profiler_zone_begin_counters(name), name)
+#else
+// Scoped zones need the cleanup attribute; use RC_PROFILE_BEGIN/END on other compilers.
+#define RC_PROFILE_SCOPE(name)
+#define RC_PROFILE_SCOPE_COUNTERS(name)
+#endif
+#else
+#define RC_PROFILE_BEGIN(name)
+#define RC_PROFILE_END()
+#define RC_PROFILE_FRAME_END()
+#define RC_PROFILE_BEGIN_COUNTERS(name)
+#define RC_PROFILE_END_COUNTERS()
+#define RC_PROFILE_SCOPE(name)
+#define RC_PROFILE_SCOPE_COUNTERS(name)
+#endif
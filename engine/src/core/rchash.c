@@ -0,0 +1,567 @@
+#include "core/rchash.h"
+#include "core/rcstring.h"
+#include "core/cpu.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#if RCARCH_X64
+#include <immintrin.h>
+#endif
+
+#define PRIME32_1 0x9E3779B1u
+#define PRIME32_2 0x85EBCA77u
+#define PRIME32_3 0xC2B2AE3Du
+#define PRIME64_1 0x9E3779B185EBCA87ull
+#define PRIME64_2 0xC2B2AE3D27D4EB4Full
+#define PRIME64_3 0x165667B19E3779F9ull
+#define PRIME64_4 0x85EBCA77C2B2AE63ull
+#define PRIME64_5 0x27D4EB2F165667C5ull
+
+#define STRIPES_PER_BLOCK 16
+// Offsets into the secret. Stripe keys use [0, 23), the rest may overlap them.
+#define SCRAMBLE_SECRET_OFFSET 24
+#define LAST_STRIPE_SECRET_OFFSET 17
+#define MERGE_LOW_SECRET_OFFSET 11
+#define MERGE_HIGH_SECRET_OFFSET 3
+
+static const u64 short_secret[4] = {
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+static const u64 default_secret[RCHASH_SECRET_COUNT] = {
+    0x4d204dbf6cfbb835ull, 0xd1728f27ff5b16d9ull, 0xd6e65a11f0f9579full, 0x9c215a9f6c6464d0ull,
+    0x4d6f39c0f589d094ull, 0x27606369f9527d2full, 0xeabc76236df000f7ull, 0xf585077bdd150ceeull,
+    0x13dd5839e4be1c5eull, 0x6016014b695fcb14ull, 0x92805325b71ab05cull, 0x8e058d8b8d856dc3ull,
+    0x649536705720e504ull, 0x6fd8cf906f388740ull, 0xf8581ddac88aaea1ull, 0x735884bd2762b573ull,
+    0x18c6b281f6b6ac53ull, 0xe9c157f1696f5478ull, 0x918f08fa57c65b35ull, 0xaf5a68beccb31a61ull,
+    0x411157ab26dafc7cull, 0x112ba6bfca3c4aceull, 0x8d1de83d438a7c98ull, 0xa934aef73dc4fdceull,
+    0x06321cf377a1aba0ull, 0x002803d9dc3cf9feull, 0x5df2f9e6f5918919ull, 0x68ce5e25ebc62871ull,
+    0x5d00f46302457205ull, 0x6f38ebcbac3e66baull, 0x893b4beff543b227ull, 0x6d15488ada5dbb91ull};
+
+static const u64 initial_acc[RCHASH_ACC_COUNT] = {
+    PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+
+typedef void (*PFN_accumulate)(u64 *acc, const u8 *data, u64 stripe_count, const u64 *secret, u64 *stripe_index);
+
+// The selected kernel; 0 until the first long hash picks one.
+static _Atomic PFN_accumulate accumulate = 0;
+
+/**
+ * ****************************
+ * Primitives
+ * ****************************
+ */
+
+RCINLINE u64 read64(const u8 *p)
+{
+    u64 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+RCINLINE u64 read32(const u8 *p)
+{
+    u32 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+RCINLINE void multiply_128(u64 a, u64 b, u64 *out_low, u64 *out_high)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t result = (__uint128_t)a * b;
+    *out_low = (u64)result;
+    *out_high = (u64)(result >> 64);
+#elif defined(_MSC_VER) && RCARCH_X64
+    *out_low = _umul128(a, b, out_high);
+#else
+    u64 a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+    u64 b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+    u64 low_low = a_low * b_low;
+    u64 high_low = a_high * b_low;
+    u64 low_high = a_low * b_high;
+    u64 high_high = a_high * b_high;
+    u64 cross = (low_low >> 32) + (high_low & 0xFFFFFFFF) + low_high;
+    *out_low = (cross << 32) | (low_low & 0xFFFFFFFF);
+    *out_high = high_high + (high_low >> 32) + (cross >> 32);
+#endif
+}
+
+RCINLINE u64 mix(u64 a, u64 b)
+{
+    u64 low, high;
+    multiply_128(a, b, &low, &high);
+    return low ^ high;
+}
+
+RCINLINE u64 avalanche(u64 h)
+{
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ull;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * ****************************
+ * Short inputs (<= RCHASH_SHORT_MAX)
+ * ****************************
+ */
+
+static u64 hash_short(const u8 *p, u64 length, u64 seed)
+{
+    seed ^= mix(seed ^ short_secret[0], short_secret[1]);
+
+    u64 a, b;
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            u64 quarter = (length >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + quarter);
+            b = (read32(p + length - 4) << 32) | read32(p + length - 4 - quarter);
+        }
+        else if (length > 0)
+        {
+            a = ((u64)p[0] << 16) | ((u64)p[length >> 1] << 8) | p[length - 1];
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        u64 remaining = length;
+        if (remaining > 48)
+        {
+            u64 see1 = seed;
+            u64 see2 = seed;
+            do
+            {
+                seed = mix(read64(p) ^ short_secret[1], read64(p + 8) ^ seed);
+                see1 = mix(read64(p + 16) ^ short_secret[2], read64(p + 24) ^ see1);
+                see2 = mix(read64(p + 32) ^ short_secret[3], read64(p + 40) ^ see2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= see1 ^ see2;
+        }
+
+        while (remaining > 16)
+        {
+            seed = mix(read64(p) ^ short_secret[1], read64(p + 8) ^ seed);
+            remaining -= 16;
+            p += 16;
+        }
+
+        // May reach back before p; length > 16 guarantees those bytes exist.
+        a = read64(p + remaining - 16);
+        b = read64(p + remaining - 8);
+    }
+
+    a ^= short_secret[1];
+    b ^= seed;
+    multiply_128(a, b, &a, &b);
+    return mix(a ^ short_secret[0] ^ length, b ^ short_secret[1]);
+}
+
+/**
+ * ****************************
+ * Long inputs: 64-byte stripes into 8 accumulators
+ * ****************************
+ */
+
+static void accumulate_stripe_scalar(u64 *acc, const u8 *stripe, const u64 *key)
+{
+    for (u32 i = 0; i < RCHASH_ACC_COUNT; ++i)
+    {
+        u64 data = read64(stripe + i * 8);
+        u64 keyed = data ^ key[i];
+        acc[i ^ 1] += data;
+        acc[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+    }
+}
+
+static void scramble_scalar(u64 *acc, const u64 *key)
+{
+    for (u32 i = 0; i < RCHASH_ACC_COUNT; ++i)
+    {
+        u64 value = acc[i];
+        value ^= value >> 47;
+        value ^= key[i];
+        acc[i] = value * PRIME32_1;
+    }
+}
+
+static void accumulate_scalar(u64 *acc, const u8 *data, u64 stripe_count, const u64 *secret, u64 *stripe_index)
+{
+    u64 index = *stripe_index;
+    for (u64 s = 0; s < stripe_count; ++s)
+    {
+        accumulate_stripe_scalar(acc, data + s * RCHASH_STRIPE_SIZE, secret + index);
+        if (++index == STRIPES_PER_BLOCK)
+        {
+            scramble_scalar(acc, secret + SCRAMBLE_SECRET_OFFSET);
+            index = 0;
+        }
+    }
+    *stripe_index = index;
+}
+
+#if RCARCH_X64
+static void accumulate_sse2(u64 *acc, const u8 *data, u64 stripe_count, const u64 *secret, u64 *stripe_index)
+{
+    const __m128i prime = _mm_set1_epi32((i32)PRIME32_1);
+    __m128i lanes[4];
+    for (u32 i = 0; i < 4; ++i)
+    {
+        lanes[i] = _mm_loadu_si128((const __m128i *)acc + i);
+    }
+
+    u64 index = *stripe_index;
+    for (u64 s = 0; s < stripe_count; ++s)
+    {
+        const u8 *stripe = data + s * RCHASH_STRIPE_SIZE;
+        const u64 *key = secret + index;
+        for (u32 i = 0; i < 4; ++i)
+        {
+            __m128i value = _mm_loadu_si128((const __m128i *)stripe + i);
+            __m128i keyed = _mm_xor_si128(value, _mm_loadu_si128((const __m128i *)(key + i * 2)));
+            // Multiply the low and high 32 bits of each keyed 64-bit lane.
+            __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+            lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+        }
+
+        if (++index == STRIPES_PER_BLOCK)
+        {
+            const u64 *scramble_key = secret + SCRAMBLE_SECRET_OFFSET;
+            for (u32 i = 0; i < 4; ++i)
+            {
+                __m128i value = _mm_xor_si128(lanes[i], _mm_srli_epi64(lanes[i], 47));
+                value = _mm_xor_si128(value, _mm_loadu_si128((const __m128i *)(scramble_key + i * 2)));
+                __m128i low = _mm_mul_epu32(value, prime);
+                __m128i high = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+                lanes[i] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+            }
+            index = 0;
+        }
+    }
+
+    for (u32 i = 0; i < 4; ++i)
+    {
+        _mm_storeu_si128((__m128i *)acc + i, lanes[i]);
+    }
+    *stripe_index = index;
+}
+
+RCTARGET_AVX2 static void accumulate_avx2(u64 *acc, const u8 *data, u64 stripe_count, const u64 *secret, u64 *stripe_index)
+{
+    const __m256i prime = _mm256_set1_epi32((i32)PRIME32_1);
+    __m256i lanes[2];
+    for (u32 i = 0; i < 2; ++i)
+    {
+        lanes[i] = _mm256_loadu_si256((const __m256i *)acc + i);
+    }
+
+    u64 index = *stripe_index;
+    for (u64 s = 0; s < stripe_count; ++s)
+    {
+        const u8 *stripe = data + s * RCHASH_STRIPE_SIZE;
+        const u64 *key = secret + index;
+        for (u32 i = 0; i < 2; ++i)
+        {
+            __m256i value = _mm256_loadu_si256((const __m256i *)stripe + i);
+            __m256i keyed = _mm256_xor_si256(value, _mm256_loadu_si256((const __m256i *)(key + i * 4)));
+            __m256i product = _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+            lanes[i] = _mm256_add_epi64(lanes[i], _mm256_add_epi64(product, swapped));
+        }
+
+        if (++index == STRIPES_PER_BLOCK)
+        {
+            const u64 *scramble_key = secret + SCRAMBLE_SECRET_OFFSET;
+            for (u32 i = 0; i < 2; ++i)
+            {
+                __m256i value = _mm256_xor_si256(lanes[i], _mm256_srli_epi64(lanes[i], 47));
+                value = _mm256_xor_si256(value, _mm256_loadu_si256((const __m256i *)(scramble_key + i * 4)));
+                __m256i low = _mm256_mul_epu32(value, prime);
+                __m256i high = _mm256_mul_epu32(_mm256_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+                lanes[i] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+            }
+            index = 0;
+        }
+    }
+
+    for (u32 i = 0; i < 2; ++i)
+    {
+        _mm256_storeu_si256((__m256i *)acc + i, lanes[i]);
+    }
+    *stripe_index = index;
+}
+#endif
+
+static PFN_accumulate select_accumulate(rchash_kernel kernel)
+{
+#if RCARCH_X64
+    b8 avx2 = cpu_has_feature(CPU_FEATURE_AVX2);
+    b8 sse2 = cpu_has_feature(CPU_FEATURE_SSE2);
+#else
+    b8 avx2 = false;
+    b8 sse2 = false;
+#endif
+
+    switch (kernel)
+    {
+    case RCHASH_KERNEL_AUTO:
+        return avx2 ? select_accumulate(RCHASH_KERNEL_AVX2) : sse2 ? select_accumulate(RCHASH_KERNEL_SSE2) : accumulate_scalar;
+    case RCHASH_KERNEL_SCALAR:
+        return accumulate_scalar;
+#if RCARCH_X64
+    case RCHASH_KERNEL_SSE2:
+        return sse2 ? accumulate_sse2 : 0;
+    case RCHASH_KERNEL_AVX2:
+        return avx2 ? accumulate_avx2 : 0;
+#endif
+    default:
+        return 0;
+    }
+}
+
+static PFN_accumulate get_accumulate()
+{
+    PFN_accumulate kernel = atomic_load_explicit(&accumulate, memory_order_relaxed);
+    if (!kernel)
+    {
+        // Threads racing here all pick, and store, the same kernel.
+        kernel = select_accumulate(RCHASH_KERNEL_AUTO);
+        atomic_store_explicit(&accumulate, kernel, memory_order_relaxed);
+    }
+
+    return kernel;
+}
+
+b8 rchash_set_kernel(rchash_kernel kernel)
+{
+    PFN_accumulate selected = select_accumulate(kernel);
+    if (!selected)
+    {
+        return false;
+    }
+
+    atomic_store_explicit(&accumulate, selected, memory_order_relaxed);
+    return true;
+}
+
+static void derive_secret(u64 seed, u64 *out_secret)
+{
+    for (u32 i = 0; i < RCHASH_SECRET_COUNT; ++i)
+    {
+        out_secret[i] = default_secret[i] + ((i & 1) ? (0 - seed) : seed);
+    }
+}
+
+static u64 merge_accumulators(const u64 *acc, const u64 *key, u64 start)
+{
+    u64 result = start;
+    for (u32 i = 0; i < RCHASH_ACC_COUNT; i += 2)
+    {
+        result += mix(acc[i] ^ key[i], acc[i + 1] ^ key[i + 1]);
+    }
+
+    return avalanche(result);
+}
+
+/**
+ * Runs every stripe but the last through the accumulators, then the final
+ * (possibly overlapping) stripe with its own key.
+ */
+static void hash_long(const u8 *p, u64 length, const u64 *secret, u64 *out_acc)
+{
+    memcpy(out_acc, initial_acc, sizeof(initial_acc));
+
+    u64 stripe_index = 0;
+    get_accumulate()(out_acc, p, (length - 1) / RCHASH_STRIPE_SIZE, secret, &stripe_index);
+    accumulate_stripe_scalar(out_acc, p + length - RCHASH_STRIPE_SIZE, secret + LAST_STRIPE_SECRET_OFFSET);
+}
+
+static u64 finalize64(const u64 *acc, const u64 *secret, u64 length)
+{
+    return merge_accumulators(acc, secret + MERGE_LOW_SECRET_OFFSET, length * PRIME64_1);
+}
+
+static hash128 finalize128(const u64 *acc, const u64 *secret, u64 length)
+{
+    hash128 result;
+    result.low = merge_accumulators(acc, secret + MERGE_LOW_SECRET_OFFSET, length * PRIME64_1);
+    result.high = merge_accumulators(acc, secret + MERGE_HIGH_SECRET_OFFSET, ~(length * PRIME64_2));
+    return result;
+}
+
+/**
+ * ****************************
+ * One-shot API
+ * ****************************
+ */
+
+u64 rchash64(const void *data, u64 size, u64 seed)
+{
+    const u8 *p = (const u8 *)data;
+    if (size <= RCHASH_SHORT_MAX)
+    {
+        return hash_short(p, size, seed);
+    }
+
+    u64 seeded_secret[RCHASH_SECRET_COUNT];
+    const u64 *secret = default_secret;
+    if (seed)
+    {
+        derive_secret(seed, seeded_secret);
+        secret = seeded_secret;
+    }
+
+    u64 acc[RCHASH_ACC_COUNT];
+    hash_long(p, size, secret, acc);
+    return finalize64(acc, secret, size);
+}
+
+hash128 rchash128(const void *data, u64 size, u64 seed)
+{
+    const u8 *p = (const u8 *)data;
+    if (size <= RCHASH_SHORT_MAX)
+    {
+        // Two independently seeded passes; short inputs are cheap enough to hash twice.
+        hash128 result;
+        result.low = hash_short(p, size, seed);
+        result.high = hash_short(p, size, seed ^ PRIME64_3);
+        return result;
+    }
+
+    u64 seeded_secret[RCHASH_SECRET_COUNT];
+    const u64 *secret = default_secret;
+    if (seed)
+    {
+        derive_secret(seed, seeded_secret);
+        secret = seeded_secret;
+    }
+
+    u64 acc[RCHASH_ACC_COUNT];
+    hash_long(p, size, secret, acc);
+    return finalize128(acc, secret, size);
+}
+
+u64 rchash_string64(const char *str, u64 seed)
+{
+    return rchash64(str, string_length(str), seed);
+}
+
+hash128 rchash_string128(const char *str, u64 seed)
+{
+    return rchash128(str, string_length(str), seed);
+}
+
+/**
+ * ****************************
+ * Streaming API
+ * ****************************
+ */
+
+void rchash_state_reset(rchash_state *state, u64 seed)
+{
+    memcpy(state->acc, initial_acc, sizeof(initial_acc));
+    derive_secret(seed, state->secret);
+    state->buffer_length = 0;
+    state->total_length = 0;
+    state->stripe_index = 0;
+    state->seed = seed;
+}
+
+void rchash_state_update(rchash_state *state, const void *data, u64 size)
+{
+    const u8 *p = (const u8 *)data;
+    state->total_length += size;
+
+    while (size > 0)
+    {
+        // Stripes are only consumed once more data is known to follow, so the
+        // final stripe is always left for the digest.
+        if (state->buffer_length == RCHASH_BUFFER_SIZE)
+        {
+            get_accumulate()(state->acc, state->buffer, RCHASH_BUFFER_SIZE / RCHASH_STRIPE_SIZE, state->secret, &state->stripe_index);
+            memcpy(state->previous_tail, state->buffer + RCHASH_BUFFER_SIZE - RCHASH_STRIPE_SIZE, RCHASH_STRIPE_SIZE);
+            state->buffer_length = 0;
+        }
+
+        // Large updates bypass the buffer, again keeping at least one byte back.
+        if (state->buffer_length == 0 && size > RCHASH_BUFFER_SIZE)
+        {
+            u64 stripe_count = ((size - 1) / RCHASH_BUFFER_SIZE) * (RCHASH_BUFFER_SIZE / RCHASH_STRIPE_SIZE);
+            u64 consumed = stripe_count * RCHASH_STRIPE_SIZE;
+            get_accumulate()(state->acc, p, stripe_count, state->secret, &state->stripe_index);
+            memcpy(state->previous_tail, p + consumed - RCHASH_STRIPE_SIZE, RCHASH_STRIPE_SIZE);
+            p += consumed;
+            size -= consumed;
+        }
+
+        u64 space = RCHASH_BUFFER_SIZE - state->buffer_length;
+        u64 copy_size = size < space ? size : space;
+        memcpy(state->buffer + state->buffer_length, p, copy_size);
+        state->buffer_length += copy_size;
+        p += copy_size;
+        size -= copy_size;
+    }
+}
+
+/**
+ * Finishes a copy of the accumulators with whatever is still buffered.
+ */
+static void digest_long(const rchash_state *state, u64 *out_acc)
+{
+    memcpy(out_acc, state->acc, sizeof(state->acc));
+
+    u64 stripe_index = state->stripe_index;
+    get_accumulate()(out_acc, state->buffer, (state->buffer_length - 1) / RCHASH_STRIPE_SIZE, state->secret, &stripe_index);
+
+    if (state->buffer_length >= RCHASH_STRIPE_SIZE)
+    {
+        accumulate_stripe_scalar(out_acc, state->buffer + state->buffer_length - RCHASH_STRIPE_SIZE, state->secret + LAST_STRIPE_SECRET_OFFSET);
+    }
+    else
+    {
+        // The last stripe straddles the previous flush.
+        u8 last_stripe[RCHASH_STRIPE_SIZE];
+        u64 carried = RCHASH_STRIPE_SIZE - state->buffer_length;
+        memcpy(last_stripe, state->previous_tail + state->buffer_length, carried);
+        memcpy(last_stripe + carried, state->buffer, state->buffer_length);
+        accumulate_stripe_scalar(out_acc, last_stripe, state->secret + LAST_STRIPE_SECRET_OFFSET);
+    }
+}
+
+u64 rchash_state_digest64(const rchash_state *state)
+{
+    if (state->total_length <= RCHASH_SHORT_MAX)
+    {
+        return hash_short(state->buffer, state->total_length, state->seed);
+    }
+
+    u64 acc[RCHASH_ACC_COUNT];
+    digest_long(state, acc);
+    return finalize64(acc, state->secret, state->total_length);
+}
+
+hash128 rchash_state_digest128(const rchash_state *state)
+{
+    if (state->total_length <= RCHASH_SHORT_MAX)
+    {
+        hash128 result;
+        result.low = hash_short(state->buffer, state->total_length, state->seed);
+        result.high = hash_short(state->buffer, state->total_length, state->seed ^ PRIME64_3);
+        return result;
+    }
+
+    u64 acc[RCHASH_ACC_COUNT];
+    digest_long(state, acc);
+    return finalize128(acc, state->secret, state->total_length);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * Fast non-cryptographic hashing for dictionary keys, asset content hashes,
+ * pipeline state keys and string IDs. Do not use where an attacker controls
+ * the input and collisions matter.
+ *
+ * Inputs up to RCHASH_SHORT_MAX bytes use a wyhash-style multiply-mix. Longer
+ * inputs are consumed in 64-byte stripes by eight parallel accumulators (an
+ * xxh3-style bulk path) which run on AVX2 or SSE2 when the CPU supports them.
+ * Every path produces identical results on every CPU.
+ */
+
+#define RCHASH_SHORT_MAX 128
+#define RCHASH_STRIPE_SIZE 64
+#define RCHASH_ACC_COUNT 8
+#define RCHASH_SECRET_COUNT 32
+#define RCHASH_BUFFER_SIZE 256
+
+/** The implementations of the bulk path. All of them give the same hashes. */
+typedef enum rchash_kernel
+{
+    /* The best kernel this CPU supports. */
+    RCHASH_KERNEL_AUTO = 0,
+    RCHASH_KERNEL_SCALAR,
+    RCHASH_KERNEL_SSE2,
+    RCHASH_KERNEL_AVX2
+} rchash_kernel;
+
+typedef struct hash128
+{
+    u64 low;
+    u64 high;
+} hash128;
+
+/**
+ * Incremental hashing state. Feeding data in any number of pieces yields the
+ * same result as a single call to rchash64/rchash128 over all of it.
+ */
+typedef struct rchash_state
+{
+    u64 acc[RCHASH_ACC_COUNT];
+    u64 secret[RCHASH_SECRET_COUNT];
+    u8 buffer[RCHASH_BUFFER_SIZE];
+    // The last stripe of the previously flushed buffer, needed if the final stripe straddles a flush.
+    u8 previous_tail[RCHASH_STRIPE_SIZE];
+    u64 buffer_length;
+    u64 total_length;
+    u64 stripe_index;
+    u64 seed;
+} rchash_state;
+
+/**
+ * Hashes a span of bytes to 64 bits.
+ * @param data The bytes to hash. Can be 0 if size is 0.
+ * @param size The number of bytes.
+ * @param seed The seed. Different seeds give unrelated hashes.
+ * @returns The 64-bit hash.
+ */
+RCAPI u64 rchash64(const void *data, u64 size, u64 seed);
+
+/**
+ * Hashes a span of bytes to 128 bits.
+ * @param data The bytes to hash. Can be 0 if size is 0.
+ * @param size The number of bytes.
+ * @param seed The seed. Different seeds give unrelated hashes.
+ * @returns The 128-bit hash.
+ */
+RCAPI hash128 rchash128(const void *data, u64 size, u64 seed);
+
+/**
+ * Hashes a null-terminated string to 64 bits, excluding the terminator.
+ */
+RCAPI u64 rchash_string64(const char *str, u64 seed);
+
+/**
+ * Hashes a null-terminated string to 128 bits, excluding the terminator.
+ */
+RCAPI hash128 rchash_string128(const char *str, u64 seed);
+
+/**
+ * Resets a streaming state so it can be fed with rchash_state_update.
+ * @param state The state to reset.
+ * @param seed The seed, same meaning as for rchash64.
+ */
+RCAPI void rchash_state_reset(rchash_state *state, u64 seed);
+
+/**
+ * Feeds more bytes into a streaming state.
+ * @param state The state to feed.
+ * @param data The bytes to add. Can be 0 if size is 0.
+ * @param size The number of bytes.
+ */
+RCAPI void rchash_state_update(rchash_state *state, const void *data, u64 size);
+
+/**
+ * Returns the 64-bit hash of everything fed so far. Does not modify the state,
+ * so more data can be added afterwards.
+ */
+RCAPI u64 rchash_state_digest64(const rchash_state *state);
+
+/**
+ * Returns the 128-bit hash of everything fed so far. Does not modify the state.
+ */
+RCAPI hash128 rchash_state_digest128(const rchash_state *state);
+
+/**
+ * Makes the bulk path use the given kernel rather than the best one for this
+ * CPU, so tests and benchmarks can compare them. Not to be called while other
+ * threads are hashing.
+ * @param kernel The kernel to use. RCHASH_KERNEL_AUTO restores the default.
+ * @returns false if this CPU or build cannot run the kernel; the current one is kept.
+ */
+RCAPI b8 rchash_set_kernel(rchash_kernel kernel);
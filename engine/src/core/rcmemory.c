@@ -3,8 +3,9 @@
 #include "core/logger.h"
 #include "platform/platform.h"
 #include "core/rcstring.h"
+#include "core/string_builder.h"
 
-#include <stdio.h>
+#define MEM_USAGE_STR_LENGTH 8000
 
 struct memory_stats
 {
@@ -15,7 +16,7 @@ struct memory_stats
 static const char *memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {
     "UNKNOWN    ",
     "ARRAY      ",
-    "LINEAR_ALLC"
+    "LINEAR_ALLC",
     "DARRAY     ",
     "DICT       ",
     "RING_QUEUE ",
@@ -30,7 +31,8 @@ static const char *memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {
     "TRANSFORM  ",
     "ENTITY     ",
     "ENTITY_NODE",
-    "SCENE      "};
+    "SCENE      ",
+    "PROFILER   "};
 
 static struct memory_stats stats;
 
@@ -82,51 +84,61 @@ void *rccopy_memory(void *dest, const void *source, u64 size)
     return platform_copy_memory(dest, source, size);
 }
 
+void *rcmove_memory(void *dest, const void *source, u64 size)
+{
+    return platform_move_memory(dest, source, size);
+}
+
 void *rcset_memory(void *dest, i32 value, u64 size)
 {
     return platform_set_memory(dest, value, size);
 }
 
-char *get_mem_usage_str()
+void write_mem_usage_str(string_builder *builder)
 {
     const u64 gib = 1024 * 1024 * 1024;
     const u64 mib = 1024 * 1024;
     const u64 kib = 1024;
 
-    char buffer[8000] = "System memory use (tagged):\n";
-    u64 offset = string_length(buffer);
+    string_builder_append(builder, "System memory use (tagged):\n");
 
     for (u32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i)
     {
-        char unit[4] = "XiB";
+        const char *unit = "XiB";
         float amount = 1.0f;
 
         if (stats.tagged_allocations[i] >= gib)
         {
-            unit[0] = 'G';
+            unit = "GiB";
             amount = stats.tagged_allocations[i] / (float)gib;
         }
         else if (stats.tagged_allocations[i] >= mib)
         {
-            unit[0] = 'M';
+            unit = "MiB";
             amount = stats.tagged_allocations[i] / (float)mib;
         }
         else if (stats.tagged_allocations[i] >= kib)
         {
-            unit[0] = 'K';
+            unit = "KiB";
             amount = stats.tagged_allocations[i] / (float)kib;
         }
         else
         {
-            unit[0] = 'B';
-            unit[1] = 0;
+            unit = "B";
             amount = (float)stats.tagged_allocations[i];
         }
 
-        i32 length = snprintf(buffer + offset, 8000, "  %s: %.2f%s\n", memory_tag_strings[i], amount, unit);
-        offset += length;
+        string_builder_appendf(builder, "  %s: %.2f%s\n", memory_tag_strings[i], amount, unit);
     }
+}
+
+char *get_mem_usage_str()
+{
+    char buffer[MEM_USAGE_STR_LENGTH];
+    string_builder builder;
+    string_builder_create(MEM_USAGE_STR_LENGTH, buffer, &builder);
+    write_mem_usage_str(&builder);
 
     char *out_string = string_duplicate(buffer);
     return out_string;
-}
\ No newline at end of file
+}
@@ -2,6 +2,8 @@
 
 #include "defines.h"
 
+struct string_builder;
+
 typedef enum memory_tag
 {
     MEMORY_TAG_UNKNOWN,
@@ -22,6 +24,7 @@ typedef enum memory_tag
     MEMORY_TAG_ENTITY,
     MEMORY_TAG_ENTITY_NODE,
     MEMORY_TAG_SCENE,
+    MEMORY_TAG_PROFILER,
 
     MEMORY_TAG_MAX_TAGS
 } memory_tag;
@@ -33,5 +36,18 @@ RCAPI void *rcallocate(u64 size, memory_tag tag);
 RCAPI void rcfree(void *block, u64 size, memory_tag tag);
 RCAPI void *rczero_memory(void *block, u64 size);
 RCAPI void *rccopy_memory(void *dest, const void *source, u64 size);
+// Like rccopy_memory, but the ranges may overlap.
+RCAPI void *rcmove_memory(void *dest, const void *source, u64 size);
 RCAPI void *rcset_memory(void *dest, i32 value, u64 size);
+
+/**
+ * Writes a per-tag memory usage report into the provided builder. Does not allocate.
+ * @param builder The builder to append the report to.
+ */
+RCAPI void write_mem_usage_str(struct string_builder *builder);
+
+/**
+ * Returns a per-tag memory usage report. The caller owns the returned string (MEMORY_TAG_STRING).
+ * Prefer write_mem_usage_str when a stack buffer will do.
+ */
 RCAPI char *get_mem_usage_str();
\ No newline at end of file
@@ -1,13 +1,165 @@
 #include "core/rcstring.h"
 #include "core/rcmemory.h"
+#include "core/rcstring_simd.h"
+#include "core/cpu.h"
 
+#include <stdatomic.h>
 #include <string.h>
 
-u64 string_length(const char *str)
+typedef u64 (*PFN_string_length)(const char *str);
+typedef b8 (*PFN_strings_equal)(const char *str0, const char *str1);
+typedef i64 (*PFN_string_find_char)(const char *str, char c);
+typedef i64 (*PFN_string_find)(const char *str, u64 str_length, const char *substring, u64 substring_length);
+
+typedef struct string_dispatch
+{
+    PFN_string_length length;
+    PFN_strings_equal equal;
+    PFN_strings_equal equali;
+    PFN_string_find_char find_char;
+    PFN_string_find find;
+} string_dispatch;
+
+// The selected table; 0 until string_initialize or the first call that needs it.
+static const string_dispatch *_Atomic active_dispatch = 0;
+
+/**
+ * ****************************
+ * Scalar fallbacks
+ * ****************************
+ */
+
+static u64 string_length_scalar(const char *str)
 {
     return strlen(str);
 }
 
+static b8 strings_equal_scalar(const char *str0, const char *str1)
+{
+    return strcmp(str0, str1) == 0;
+}
+
+static b8 strings_equali_scalar(const char *str0, const char *str1)
+{
+    for (;; ++str0, ++str1)
+    {
+        char a = (*str0 >= 'A' && *str0 <= 'Z') ? (char)(*str0 + ('a' - 'A')) : *str0;
+        char b = (*str1 >= 'A' && *str1 <= 'Z') ? (char)(*str1 + ('a' - 'A')) : *str1;
+        if (a != b)
+        {
+            return false;
+        }
+        if (a == 0)
+        {
+            return true;
+        }
+    }
+}
+
+static i64 string_find_char_scalar(const char *str, char c)
+{
+    const char *hit = strchr(str, c);
+    return hit ? (i64)(hit - str) : -1;
+}
+
+static i64 string_find_scalar(const char *str, u64 str_length, const char *substring, u64 substring_length)
+{
+    for (u64 i = 0; i + substring_length <= str_length; ++i)
+    {
+        if (str[i] == substring[0] && memcmp(str + i, substring, substring_length) == 0)
+        {
+            return (i64)i;
+        }
+    }
+
+    return -1;
+}
+
+static const string_dispatch scalar_dispatch = {
+    string_length_scalar,
+    strings_equal_scalar,
+    strings_equali_scalar,
+    string_find_char_scalar,
+    string_find_scalar};
+
+#if RCARCH_X64
+static const string_dispatch sse2_dispatch = {
+    string_length_sse2,
+    strings_equal_sse2,
+    strings_equali_sse2,
+    string_find_char_sse2,
+    string_find_sse2};
+
+static const string_dispatch avx2_dispatch = {
+    string_length_avx2,
+    strings_equal_avx2,
+    strings_equali_avx2,
+    string_find_char_avx2,
+    string_find_avx2};
+#endif
+
+static const string_dispatch *select_dispatch(string_kernel kernel)
+{
+#if RCARCH_X64
+    b8 avx2 = cpu_has_feature(CPU_FEATURE_AVX2);
+    b8 sse2 = cpu_has_feature(CPU_FEATURE_SSE2);
+#else
+    b8 avx2 = false;
+    b8 sse2 = false;
+#endif
+
+    switch (kernel)
+    {
+    case STRING_KERNEL_AUTO:
+        return avx2 ? select_dispatch(STRING_KERNEL_AVX2) : sse2 ? select_dispatch(STRING_KERNEL_SSE2) : &scalar_dispatch;
+    case STRING_KERNEL_SCALAR:
+        return &scalar_dispatch;
+#if RCARCH_X64
+    case STRING_KERNEL_SSE2:
+        return sse2 ? &sse2_dispatch : 0;
+    case STRING_KERNEL_AVX2:
+        return avx2 ? &avx2_dispatch : 0;
+#endif
+    default:
+        return 0;
+    }
+}
+
+void string_initialize()
+{
+    atomic_store_explicit(&active_dispatch, select_dispatch(STRING_KERNEL_AUTO), memory_order_release);
+}
+
+b8 string_set_kernel(string_kernel kernel)
+{
+    const string_dispatch *selected = select_dispatch(kernel);
+    if (!selected)
+    {
+        return false;
+    }
+
+    atomic_store_explicit(&active_dispatch, selected, memory_order_release);
+    return true;
+}
+
+RCINLINE const string_dispatch *get_dispatch()
+{
+    const string_dispatch *dispatch = atomic_load_explicit(&active_dispatch, memory_order_acquire);
+    if (!dispatch)
+    {
+        // Only reached by programs that skip string_initialize. Every thread that gets here picks the same table.
+        dispatch = select_dispatch(STRING_KERNEL_AUTO);
+        atomic_store_explicit(&active_dispatch, dispatch, memory_order_release);
+    }
+
+    return dispatch;
+}
+
+u64 string_length(const char *str)
+{
+    return get_dispatch()->length(str);
+}
+
 char *string_duplicate(const char *str)
 {
     u64 length = string_length(str);
@@ -19,5 +171,816 @@ char *string_duplicate(const char *str)
 
 b8 strings_equal(const char *str0, const char *str1)
 {
-    return strcmp(str0, str1) == 0;
-}
\ No newline at end of file
+    return get_dispatch()->equal(str0, str1);
+}
+
+b8 strings_equali(const char *str0, const char *str1)
+{
+    return get_dispatch()->equali(str0, str1);
+}
+
+i64 string_find_char(const char *str, char c)
+{
+    return get_dispatch()->find_char(str, c);
+}
+
+i64 string_find(const char *str, const char *substring)
+{
+    const string_dispatch *d = get_dispatch();
+    u64 substring_length = d->length(substring);
+    if (substring_length == 0)
+    {
+        return 0;
+    }
+
+    if (substring_length == 1)
+    {
+        return d->find_char(str, substring[0]);
+    }
+
+    u64 str_length = d->length(str);
+    if (substring_length > str_length)
+    {
+        return -1;
+    }
+
+    return d->find(str, str_length, substring, substring_length);
+}
+
+/**
+ * ****************************
+ * Formatting
+ * ****************************
+ */
+
+#define FORMAT_FLAG_LEFT 0x01
+#define FORMAT_FLAG_ZERO 0x02
+#define FORMAT_FLAG_PLUS 0x04
+#define FORMAT_FLAG_SPACE 0x08
+
+// Max digits printed after the decimal point for %f. Beyond this, u64 fraction math overflows.
+#define FORMAT_MAX_FLOAT_PRECISION 17
+
+typedef struct format_output
+{
+    char *dest;
+    u64 capacity;
+    // Length of the full output, even if it did not fit in dest.
+    u64 length;
+} format_output;
+
+typedef struct format_spec
+{
+    u8 flags;
+    i32 width;
+    // -1 when no precision was specified.
+    i32 precision;
+} format_spec;
+
+RCINLINE void format_put(format_output *out, char c)
+{
+    if (out->length + 1 < out->capacity)
+    {
+        out->dest[out->length] = c;
+    }
+    out->length++;
+}
+
+static void format_put_chars(format_output *out, const char *chars, u64 count)
+{
+    if (count == 0)
+    {
+        // chars may be null for an empty prefix.
+        return;
+    }
+
+    if (out->length + 1 < out->capacity)
+    {
+        u64 space = out->capacity - 1 - out->length;
+        u64 copy_count = count < space ? count : space;
+        memcpy(out->dest + out->length, chars, copy_count);
+    }
+    out->length += count;
+}
+
+static void format_put_repeat(format_output *out, char c, i64 count)
+{
+    for (i64 i = 0; i < count; ++i)
+    {
+        format_put(out, c);
+    }
+}
+
+/**
+ * Writes a prefix (sign, 0x) and a body, padded out to the width of the spec.
+ * Zero padding is inserted between the prefix and the body.
+ */
+static void format_put_field(format_output *out, const format_spec *spec, const char *prefix, u64 prefix_length, const char *body, u64 body_length, b8 allow_zero_pad)
+{
+    i64 padding = (i64)spec->width - (i64)(prefix_length + body_length);
+    b8 zero_pad = allow_zero_pad && (spec->flags & FORMAT_FLAG_ZERO) && !(spec->flags & FORMAT_FLAG_LEFT);
+
+    if (!(spec->flags & FORMAT_FLAG_LEFT) && !zero_pad)
+    {
+        format_put_repeat(out, ' ', padding);
+    }
+
+    format_put_chars(out, prefix, prefix_length);
+
+    if (zero_pad)
+    {
+        format_put_repeat(out, '0', padding);
+    }
+
+    format_put_chars(out, body, body_length);
+
+    if (spec->flags & FORMAT_FLAG_LEFT)
+    {
+        format_put_repeat(out, ' ', padding);
+    }
+}
+
+/**
+ * Writes the digits of value into the end of buffer, returning a pointer to the first digit.
+ */
+static char *format_u64_digits(u64 value, u32 base, b8 uppercase, char *buffer_end, u64 *out_length)
+{
+    const char *digits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    char *cursor = buffer_end;
+    do
+    {
+        *--cursor = digits[value % base];
+        value /= base;
+    } while (value);
+
+    *out_length = (u64)(buffer_end - cursor);
+    return cursor;
+}
+
+static void format_integer(format_output *out, const format_spec *spec, u64 magnitude, b8 negative, u32 base, b8 uppercase, b8 alternate)
+{
+    char buffer[64];
+    char *end = buffer + sizeof(buffer);
+    u64 digit_count = 0;
+    char *digits = format_u64_digits(magnitude, base, uppercase, end, &digit_count);
+
+    // An explicit precision of zero prints nothing for a zero value.
+    if (spec->precision == 0 && magnitude == 0)
+    {
+        digits = end;
+        digit_count = 0;
+    }
+
+    // Precision is the minimum digit count for integers.
+    while (spec->precision > 0 && digit_count < (u64)spec->precision && digits > buffer)
+    {
+        *--digits = '0';
+        digit_count++;
+    }
+
+    char prefix[3];
+    u64 prefix_length = 0;
+    if (negative)
+    {
+        prefix[prefix_length++] = '-';
+    }
+    else if (spec->flags & FORMAT_FLAG_PLUS)
+    {
+        prefix[prefix_length++] = '+';
+    }
+    else if (spec->flags & FORMAT_FLAG_SPACE)
+    {
+        prefix[prefix_length++] = ' ';
+    }
+
+    if (alternate)
+    {
+        prefix[prefix_length++] = '0';
+        prefix[prefix_length++] = uppercase ? 'X' : 'x';
+    }
+
+    // Zero padding is ignored when a precision is given, same as printf.
+    format_put_field(out, spec, prefix, prefix_length, digits, digit_count, spec->precision < 0);
+}
+
+static void format_float(format_output *out, const format_spec *spec, f64 value)
+{
+    char prefix[1];
+    u64 prefix_length = 0;
+
+    b8 negative = value < 0.0 || (value == 0.0 && (1.0 / value) < 0.0);
+    if (negative)
+    {
+        value = -value;
+        prefix[prefix_length++] = '-';
+    }
+    else if (spec->flags & FORMAT_FLAG_PLUS)
+    {
+        prefix[prefix_length++] = '+';
+    }
+    else if (spec->flags & FORMAT_FLAG_SPACE)
+    {
+        prefix[prefix_length++] = ' ';
+    }
+
+    if (value != value)
+    {
+        format_put_field(out, spec, prefix, prefix_length, "nan", 3, false);
+        return;
+    }
+
+    if (value > 1.7976931348623157e308)
+    {
+        format_put_field(out, spec, prefix, prefix_length, "inf", 3, false);
+        return;
+    }
+
+    i32 precision = spec->precision < 0 ? 6 : spec->precision;
+    i32 extra_zeros = 0;
+    if (precision > FORMAT_MAX_FLOAT_PRECISION)
+    {
+        extra_zeros = precision - FORMAT_MAX_FLOAT_PRECISION;
+        precision = FORMAT_MAX_FLOAT_PRECISION;
+    }
+
+    u64 scale = 1;
+    for (i32 i = 0; i < precision; ++i)
+    {
+        scale *= 10;
+    }
+
+    // Values that do not fit in a u64 are scaled down and the dropped digits written as zeros.
+    i32 integer_zeros = 0;
+    while (value >= 18446744073709551615.0)
+    {
+        value /= 10.0;
+        integer_zeros++;
+    }
+
+    u64 integer_part = (u64)value;
+    f64 remainder = (value - (f64)integer_part) * (f64)scale;
+    u64 fraction_part = (u64)remainder;
+    f64 rounding = remainder - (f64)fraction_part;
+
+    // Round half to even on the last printed digit.
+    u64 last_digit = precision > 0 ? fraction_part : integer_part;
+    if (rounding > 0.5 || (rounding == 0.5 && (last_digit & 1)))
+    {
+        fraction_part++;
+        if (fraction_part >= scale)
+        {
+            fraction_part -= scale;
+            integer_part++;
+        }
+    }
+
+    char buffer[64];
+    char *end = buffer + sizeof(buffer);
+    char *cursor = end;
+
+    if (precision > 0)
+    {
+        for (i32 i = 0; i < precision; ++i)
+        {
+            *--cursor = (char)('0' + (fraction_part % 10));
+            fraction_part /= 10;
+        }
+        *--cursor = '.';
+    }
+
+    u64 digit_count = 0;
+    char *digits = format_u64_digits(integer_part, 10, false, cursor, &digit_count);
+    u64 body_length = (u64)(end - digits);
+
+    if (integer_zeros == 0 && extra_zeros == 0)
+    {
+        format_put_field(out, spec, prefix, prefix_length, digits, body_length, true);
+        return;
+    }
+
+    // Rare path for huge values or large precision; pad manually around the extra zeros.
+    i64 total = (i64)(prefix_length + body_length) + integer_zeros + extra_zeros;
+    i64 padding = (i64)spec->width - total;
+    b8 zero_pad = (spec->flags & FORMAT_FLAG_ZERO) && !(spec->flags & FORMAT_FLAG_LEFT);
+
+    if (!(spec->flags & FORMAT_FLAG_LEFT) && !zero_pad)
+    {
+        format_put_repeat(out, ' ', padding);
+    }
+    format_put_chars(out, prefix, prefix_length);
+    if (zero_pad)
+    {
+        format_put_repeat(out, '0', padding);
+    }
+    format_put_chars(out, digits, digit_count);
+    format_put_repeat(out, '0', integer_zeros);
+    format_put_chars(out, digits + digit_count, body_length - digit_count);
+    format_put_repeat(out, '0', extra_zeros);
+    if (spec->flags & FORMAT_FLAG_LEFT)
+    {
+        format_put_repeat(out, ' ', padding);
+    }
+}
+
+/**
+ * Where the conversions of a format string take their arguments from: a
+ * va_list, or a buffer written by string_format_pack_v. When pack_dest is
+ * set, arguments read from the va_list are also appended to it and nothing
+ * is formatted.
+ */
+typedef struct format_args
+{
+    va_list *list;
+
+    const u8 *packed;
+    const u8 *packed_end;
+
+    b8 packing;
+    u8 *pack_dest;
+    u64 pack_capacity;
+    // Length of the full packed output, even if it did not fit in pack_dest.
+    u64 pack_length;
+} format_args;
+
+static void format_pack(format_args *args, const void *data, u64 size)
+{
+    if (args->pack_length + size <= args->pack_capacity)
+    {
+        memcpy(args->pack_dest + args->pack_length, data, size);
+    }
+    args->pack_length += size;
+}
+
+static u64 format_unpack(format_args *args)
+{
+    u64 value = 0;
+    if (args->packed + sizeof(u64) <= args->packed_end)
+    {
+        memcpy(&value, args->packed, sizeof(u64));
+        args->packed += sizeof(u64);
+    }
+    return value;
+}
+
+static i64 format_arg_signed(format_args *args, i32 size)
+{
+    if (args->packed)
+    {
+        return (i64)format_unpack(args);
+    }
+
+    i64 value;
+    if (size == 2)
+    {
+        value = va_arg(*args->list, long long);
+    }
+    else if (size == 1)
+    {
+        value = va_arg(*args->list, long);
+    }
+    else if (size == 3)
+    {
+        value = (i64)va_arg(*args->list, u64);
+    }
+    else
+    {
+        value = va_arg(*args->list, int);
+        if (size == -1)
+        {
+            value = (i16)value;
+        }
+        else if (size == -2)
+        {
+            value = (i8)value;
+        }
+    }
+
+    if (args->packing)
+    {
+        format_pack(args, &value, sizeof(value));
+    }
+    return value;
+}
+
+static u64 format_arg_unsigned(format_args *args, i32 size)
+{
+    if (args->packed)
+    {
+        return format_unpack(args);
+    }
+
+    u64 value;
+    if (size == 2)
+    {
+        value = va_arg(*args->list, unsigned long long);
+    }
+    else if (size == 1)
+    {
+        value = va_arg(*args->list, unsigned long);
+    }
+    else if (size == 3)
+    {
+        value = va_arg(*args->list, u64);
+    }
+    else
+    {
+        value = va_arg(*args->list, unsigned int);
+        if (size == -1)
+        {
+            value = (u16)value;
+        }
+        else if (size == -2)
+        {
+            value = (u8)value;
+        }
+    }
+
+    if (args->packing)
+    {
+        format_pack(args, &value, sizeof(value));
+    }
+    return value;
+}
+
+static u64 format_arg_pointer(format_args *args)
+{
+    if (args->packed)
+    {
+        return format_unpack(args);
+    }
+
+    u64 value = (u64)va_arg(*args->list, void *);
+    if (args->packing)
+    {
+        format_pack(args, &value, sizeof(value));
+    }
+    return value;
+}
+
+static f64 format_arg_float(format_args *args)
+{
+    f64 value;
+    if (args->packed)
+    {
+        u64 bits = format_unpack(args);
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    value = va_arg(*args->list, f64);
+    if (args->packing)
+    {
+        format_pack(args, &value, sizeof(value));
+    }
+    return value;
+}
+
+/**
+ * Strings are packed by value, as a u64 length followed by the characters
+ * padded to 8 bytes, since the original may be gone by the time they are formatted.
+ */
+static const char *format_arg_string(format_args *args, i32 precision, u64 *out_length)
+{
+    if (args->packed)
+    {
+        u64 length = format_unpack(args);
+        u64 available = (u64)(args->packed_end - args->packed);
+        if (length > available)
+        {
+            length = available;
+        }
+        const char *value = (const char *)args->packed;
+        u64 padded = (length + 7) & ~(u64)7;
+        args->packed += padded < available ? padded : available;
+        *out_length = length;
+        return value;
+    }
+
+    const char *value = va_arg(*args->list, const char *);
+    if (!value)
+    {
+        value = "(null)";
+    }
+
+    u64 length = 0;
+    if (precision >= 0)
+    {
+        // Never read past the precision; the string might not be terminated.
+        while (length < (u64)precision && value[length])
+        {
+            length++;
+        }
+    }
+    else
+    {
+        length = string_length(value);
+    }
+
+    if (args->packing)
+    {
+        static const u8 zeros[8] = {0};
+        format_pack(args, &length, sizeof(length));
+        format_pack(args, value, length);
+        format_pack(args, zeros, ((length + 7) & ~(u64)7) - length);
+    }
+
+    *out_length = length;
+    return value;
+}
+
+static void format_core(format_output *out, const char *format, format_args *args)
+{
+    b8 packing = args->packing;
+    const char *cursor = format;
+    while (*cursor)
+    {
+        // Copy literal runs in one go.
+        const char *run_start = cursor;
+        while (*cursor && *cursor != '%')
+        {
+            cursor++;
+        }
+        if (cursor != run_start && !packing)
+        {
+            format_put_chars(out, run_start, (u64)(cursor - run_start));
+        }
+
+        if (!*cursor)
+        {
+            break;
+        }
+
+        const char *spec_start = cursor;
+        cursor++; // Skip the %.
+
+        format_spec spec;
+        spec.flags = 0;
+        spec.width = 0;
+        spec.precision = -1;
+
+        // Flags
+        for (;; ++cursor)
+        {
+            if (*cursor == '-')
+            {
+                spec.flags |= FORMAT_FLAG_LEFT;
+            }
+            else if (*cursor == '0')
+            {
+                spec.flags |= FORMAT_FLAG_ZERO;
+            }
+            else if (*cursor == '+')
+            {
+                spec.flags |= FORMAT_FLAG_PLUS;
+            }
+            else if (*cursor == ' ')
+            {
+                spec.flags |= FORMAT_FLAG_SPACE;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        // Width
+        if (*cursor == '*')
+        {
+            spec.width = (i32)format_arg_signed(args, 0);
+            if (spec.width < 0)
+            {
+                spec.flags |= FORMAT_FLAG_LEFT;
+                spec.width = -spec.width;
+            }
+            cursor++;
+        }
+        else
+        {
+            while (*cursor >= '0' && *cursor <= '9')
+            {
+                spec.width = spec.width * 10 + (*cursor - '0');
+                cursor++;
+            }
+        }
+
+        // Precision
+        if (*cursor == '.')
+        {
+            cursor++;
+            spec.precision = 0;
+            if (*cursor == '*')
+            {
+                spec.precision = (i32)format_arg_signed(args, 0);
+                if (spec.precision < 0)
+                {
+                    spec.precision = -1;
+                }
+                cursor++;
+            }
+            else
+            {
+                while (*cursor >= '0' && *cursor <= '9')
+                {
+                    spec.precision = spec.precision * 10 + (*cursor - '0');
+                    cursor++;
+                }
+            }
+        }
+
+        // Length modifier: 0 = int, 1 = long, 2 = long long, 3 = size_t, -1 = short, -2 = char.
+        i32 size = 0;
+        if (*cursor == 'h')
+        {
+            size = -1;
+            cursor++;
+            if (*cursor == 'h')
+            {
+                size = -2;
+                cursor++;
+            }
+        }
+        else if (*cursor == 'l')
+        {
+            size = 1;
+            cursor++;
+            if (*cursor == 'l')
+            {
+                size = 2;
+                cursor++;
+            }
+        }
+        else if (*cursor == 'z')
+        {
+            size = 3;
+            cursor++;
+        }
+
+        char conversion = *cursor;
+        if (conversion)
+        {
+            cursor++;
+        }
+
+        switch (conversion)
+        {
+        case 'd':
+        case 'i':
+        {
+            i64 value = format_arg_signed(args, size);
+            if (packing)
+            {
+                break;
+            }
+
+            b8 negative = value < 0;
+            u64 magnitude = negative ? (u64)0 - (u64)value : (u64)value;
+            format_integer(out, &spec, magnitude, negative, 10, false, false);
+        }
+        break;
+        case 'u':
+        case 'x':
+        case 'X':
+        {
+            u64 value = format_arg_unsigned(args, size);
+            if (packing)
+            {
+                break;
+            }
+
+            u32 base = conversion == 'u' ? 10 : 16;
+            format_integer(out, &spec, value, false, base, conversion == 'X', false);
+        }
+        break;
+        case 'p':
+        {
+            u64 value = format_arg_pointer(args);
+            if (packing)
+            {
+                break;
+            }
+
+            format_spec pointer_spec = spec;
+            pointer_spec.flags &= ~(FORMAT_FLAG_PLUS | FORMAT_FLAG_SPACE);
+            format_integer(out, &pointer_spec, value, false, 16, false, true);
+        }
+        break;
+        case 'f':
+        case 'F':
+        {
+            f64 value = format_arg_float(args);
+            if (packing)
+            {
+                break;
+            }
+
+            format_float(out, &spec, value);
+        }
+        break;
+        case 'c':
+        {
+            char value = (char)format_arg_signed(args, 0);
+            if (packing)
+            {
+                break;
+            }
+
+            format_put_field(out, &spec, 0, 0, &value, 1, false);
+        }
+        break;
+        case 's':
+        {
+            u64 length = 0;
+            const char *value = format_arg_string(args, spec.precision, &length);
+            if (packing)
+            {
+                break;
+            }
+
+            format_put_field(out, &spec, 0, 0, value, length, false);
+        }
+        break;
+        case '%':
+            if (!packing)
+            {
+                format_put(out, '%');
+            }
+            break;
+        default:
+            // Unknown conversion, emit it verbatim.
+            if (!packing)
+            {
+                format_put_chars(out, spec_start, (u64)(cursor - spec_start));
+            }
+            break;
+        }
+    }
+}
+
+static u64 format_finish(format_output *out)
+{
+    if (out->capacity > 0)
+    {
+        out->dest[out->length < out->capacity ? out->length : out->capacity - 1] = 0;
+    }
+
+    return out->length;
+}
+
+u64 string_format(char *dest, u64 capacity, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    u64 length = string_format_v(dest, capacity, format, args);
+    va_end(args);
+    return length;
+}
+
+u64 string_format_v(char *dest, u64 capacity, const char *format, va_list args)
+{
+    format_output out;
+    out.dest = dest;
+    out.capacity = capacity;
+    out.length = 0;
+
+    va_list list;
+    va_copy(list, args);
+    format_args source = {0};
+    source.list = &list;
+
+    format_core(&out, format, &source);
+    va_end(list);
+
+    return format_finish(&out);
+}
+
+u64 string_format_pack_v(void *dest, u64 capacity, const char *format, va_list args)
+{
+    va_list list;
+    va_copy(list, args);
+    format_args source = {0};
+    source.list = &list;
+    source.packing = true;
+    source.pack_dest = dest;
+    source.pack_capacity = capacity;
+
+    format_core(0, format, &source);
+    va_end(list);
+
+    return source.pack_length;
+}
+
+u64 string_format_packed(char *dest, u64 capacity, const char *format, const void *packed, u64 packed_size)
+{
+    format_output out;
+    out.dest = dest;
+    out.capacity = capacity;
+    out.length = 0;
+
+    format_args source = {0};
+    source.packed = packed;
+    source.packed_end = (const u8 *)packed + packed_size;
+
+    format_core(&out, format, &source);
+
+    return format_finish(&out);
+}
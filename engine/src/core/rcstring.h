@@ -2,6 +2,119 @@
 
 #include "defines.h"
 
+#include <stdarg.h>
+
+/**
+ * NOTE: string_length, strings_equal, strings_equali, string_find_char and
+ * string_find dispatch to SSE2/AVX2 implementations picked by CPU detection,
+ * falling back to scalar code on other architectures.
+ */
+
+/**
+ * Picks the string implementations for this CPU. Call once at startup,
+ * before other threads use strings. Programs that skip it get the same
+ * choice made on first use.
+ */
+void string_initialize();
+
+/**
+ * The implementations behind string_length, strings_equal, strings_equali,
+ * string_find_char and string_find. All of them give the same results.
+ */
+typedef enum string_kernel
+{
+    /* The best kernel this CPU supports. */
+    STRING_KERNEL_AUTO = 0,
+    STRING_KERNEL_SCALAR,
+    STRING_KERNEL_SSE2,
+    STRING_KERNEL_AVX2
+} string_kernel;
+
+/**
+ * Makes the string functions use the given kernel rather than the best one
+ * for this CPU, so tests and benchmarks can compare them. Not to be called
+ * while other threads are using strings.
+ * @param kernel The kernel to use. STRING_KERNEL_AUTO restores the default.
+ * @returns false if this CPU or build cannot run the kernel; the current one is kept.
+ */
+RCAPI b8 string_set_kernel(string_kernel kernel);
+
 RCAPI u64 string_length(const char *str);
 RCAPI char *string_duplicate(const char *str);
-RCAPI b8 strings_equal(const char *str0, const char *str1);
\ No newline at end of file
+
+/**
+ * Case-sensitive string comparison.
+ * @returns true if the strings are equal; otherwise false.
+ */
+RCAPI b8 strings_equal(const char *str0, const char *str1);
+
+/**
+ * Case-insensitive string comparison. Only ASCII letters are folded.
+ * @returns true if the strings are equal ignoring case; otherwise false.
+ */
+RCAPI b8 strings_equali(const char *str0, const char *str1);
+
+/**
+ * Finds the first occurrence of a character.
+ * @param str The string to search.
+ * @param c The character to look for. Searching for 0 returns the string length.
+ * @returns The index of the character, or -1 if not found.
+ */
+RCAPI i64 string_find_char(const char *str, char c);
+
+/**
+ * Finds the first occurrence of a substring.
+ * @param str The string to search.
+ * @param substring The string to look for. An empty substring matches at index 0.
+ * @returns The index of the substring, or -1 if not found.
+ */
+RCAPI i64 string_find(const char *str, const char *substring);
+
+/**
+ * Formats a string into the provided buffer in a single pass. Supports the
+ * d, i, u, x, X, c, s, f, p and % conversions with flags (-, 0, +, space),
+ * width, precision and the hh, h, l, ll and z length modifiers.
+ * The output is always null-terminated when capacity is greater than 0.
+ * NOTE: %f is computed in f64 and may differ from the C runtime in the last
+ * printed digit, and prints zeros past 17 significant fraction digits.
+ * @param dest The buffer to write to. Can be 0 if capacity is 0.
+ * @param capacity The size of dest in bytes, including the null terminator.
+ * @param format The format string.
+ * @returns The length the fully formatted string would have, excluding the null terminator.
+ */
+RCAPI u64 string_format(char *dest, u64 capacity, const char *format, ...);
+
+/**
+ * Variadic list version of string_format.
+ * @param dest The buffer to write to. Can be 0 if capacity is 0.
+ * @param capacity The size of dest in bytes, including the null terminator.
+ * @param format The format string.
+ * @param args The argument list.
+ * @returns The length the fully formatted string would have, excluding the null terminator.
+ */
+RCAPI u64 string_format_v(char *dest, u64 capacity, const char *format, va_list args);
+
+/**
+ * Captures the arguments a format string consumes into a compact binary
+ * buffer without formatting anything, so string_format_packed can produce
+ * the text later, possibly on another thread. Integers, floats and pointers
+ * take 8 bytes each; %s strings are copied by value.
+ * @param dest The buffer to write to. Can be 0 if capacity is 0.
+ * @param capacity The size of dest in bytes.
+ * @param format The format string. Must stay valid until string_format_packed is called.
+ * @param args The argument list.
+ * @returns The number of bytes the packed arguments need. If this is more than capacity, dest is incomplete.
+ */
+RCAPI u64 string_format_pack_v(void *dest, u64 capacity, const char *format, va_list args);
+
+/**
+ * Formats a string like string_format, taking the arguments from a buffer
+ * written by string_format_pack_v with the same format string.
+ * @param dest The buffer to write to. Can be 0 if capacity is 0.
+ * @param capacity The size of dest in bytes, including the null terminator.
+ * @param format The format string the arguments were packed with.
+ * @param packed The packed arguments.
+ * @param packed_size The size of the packed arguments in bytes.
+ * @returns The length the fully formatted string would have, excluding the null terminator.
+ */
+RCAPI u64 string_format_packed(char *dest, u64 capacity, const char *format, const void *packed, u64 packed_size);
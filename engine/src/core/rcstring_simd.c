@@ -0,0 +1,380 @@
+#include "core/rcstring_simd.h"
+
+#if RCARCH_X64
+
+#include "core/cpu.h"
+#include "math/rcmath.h"
+
+#include <string.h>
+#include <immintrin.h>
+
+/**
+ * Loads are either aligned (and so can never cross into an unmapped page) or,
+ * for the two-string compares, only issued when the whole vector stays inside
+ * the current page. Bytes past the terminator inside that page are read but
+ * never used.
+ */
+#define PAGE_SIZE 4096
+
+// These over-reads are deliberate and safe, so keep AddressSanitizer from flagging them.
+#if defined(__clang__) || defined(__GNUC__)
+#define NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#define NO_SANITIZE_ADDRESS
+#endif
+
+RCINLINE b8 crosses_page(const char *ptr, u64 width)
+{
+    return ((u64)ptr & (PAGE_SIZE - 1)) > PAGE_SIZE - width;
+}
+
+RCINLINE char ascii_to_lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+/**
+ * ****************************
+ * SSE2
+ * ****************************
+ */
+
+RCINLINE __m128i sse2_to_lower(__m128i v)
+{
+    // Shift 'A'..'Z' to the bottom of the signed range so a single compare finds them.
+    __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - 'A')));
+    __m128i is_upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(-128 + 26)));
+    return _mm_or_si128(v, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
+}
+
+NO_SANITIZE_ADDRESS u64 string_length_sse2(const char *str)
+{
+    const __m128i zero = _mm_setzero_si128();
+    u32 offset = (u32)((u64)str & 15);
+    const char *block = str - offset;
+
+    u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)block), zero)) >> offset;
+    if (mask)
+    {
+        return count_trailing_zeros_u32(mask);
+    }
+
+    for (;;)
+    {
+        block += 16;
+        mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)block), zero));
+        if (mask)
+        {
+            return (u64)(block - str) + count_trailing_zeros_u32(mask);
+        }
+    }
+}
+
+NO_SANITIZE_ADDRESS i64 string_find_char_sse2(const char *str, char c)
+{
+    if (c == 0)
+    {
+        return (i64)string_length_sse2(str);
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i needle = _mm_set1_epi8(c);
+    u32 offset = (u32)((u64)str & 15);
+    const char *block = str - offset;
+
+    __m128i v = _mm_load_si128((const __m128i *)block);
+    u32 mask = (u32)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, needle), _mm_cmpeq_epi8(v, zero))) >> offset;
+    block += offset;
+
+    for (;;)
+    {
+        if (mask)
+        {
+            const char *hit = block + count_trailing_zeros_u32(mask);
+            return *hit == c ? (i64)(hit - str) : -1;
+        }
+
+        block = (const char *)(((u64)block & ~(u64)15) + 16);
+        v = _mm_load_si128((const __m128i *)block);
+        mask = (u32)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, needle), _mm_cmpeq_epi8(v, zero)));
+    }
+}
+
+NO_SANITIZE_ADDRESS b8 strings_equal_sse2(const char *str0, const char *str1)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for (;;)
+    {
+        if (!crosses_page(str0, 16) && !crosses_page(str1, 16))
+        {
+            __m128i a = _mm_loadu_si128((const __m128i *)str0);
+            __m128i b = _mm_loadu_si128((const __m128i *)str1);
+            u32 diff = ~(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xFFFF;
+            u32 end = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, zero));
+            u32 stop = diff | end;
+            if (stop)
+            {
+                // The first stop is either a mismatch or a shared terminator.
+                u32 index = count_trailing_zeros_u32(stop);
+                return str0[index] == str1[index];
+            }
+            str0 += 16;
+            str1 += 16;
+        }
+        else
+        {
+            // Step over the page boundary a byte at a time.
+            for (u32 i = 0; i < 16; ++i, ++str0, ++str1)
+            {
+                if (*str0 != *str1)
+                {
+                    return false;
+                }
+                if (*str0 == 0)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+}
+
+NO_SANITIZE_ADDRESS b8 strings_equali_sse2(const char *str0, const char *str1)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for (;;)
+    {
+        if (!crosses_page(str0, 16) && !crosses_page(str1, 16))
+        {
+            __m128i a = _mm_loadu_si128((const __m128i *)str0);
+            __m128i b = _mm_loadu_si128((const __m128i *)str1);
+            u32 diff = ~(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(sse2_to_lower(a), sse2_to_lower(b))) & 0xFFFF;
+            u32 end = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, zero));
+            u32 stop = diff | end;
+            if (stop)
+            {
+                u32 index = count_trailing_zeros_u32(stop);
+                return ascii_to_lower(str0[index]) == ascii_to_lower(str1[index]);
+            }
+            str0 += 16;
+            str1 += 16;
+        }
+        else
+        {
+            for (u32 i = 0; i < 16; ++i, ++str0, ++str1)
+            {
+                if (ascii_to_lower(*str0) != ascii_to_lower(*str1))
+                {
+                    return false;
+                }
+                if (*str0 == 0)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+}
+
+i64 string_find_sse2(const char *str, u64 str_length, const char *substring, u64 substring_length)
+{
+    // Filter candidates on the first and last character of the substring, then verify the middle.
+    const __m128i first = _mm_set1_epi8(substring[0]);
+    const __m128i last = _mm_set1_epi8(substring[substring_length - 1]);
+
+    u64 i = 0;
+    for (; i + 16 + substring_length - 1 <= str_length; i += 16)
+    {
+        __m128i block_first = _mm_loadu_si128((const __m128i *)(str + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i *)(str + i + substring_length - 1));
+        u32 mask = (u32)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        while (mask)
+        {
+            u32 bit = count_trailing_zeros_u32(mask);
+            if (memcmp(str + i + bit + 1, substring + 1, substring_length - 2) == 0)
+            {
+                return (i64)(i + bit);
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    for (; i + substring_length <= str_length; ++i)
+    {
+        if (str[i] == substring[0] && memcmp(str + i, substring, substring_length) == 0)
+        {
+            return (i64)i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * ****************************
+ * AVX2
+ * ****************************
+ */
+
+RCTARGET_AVX2 RCINLINE __m256i avx2_to_lower(__m256i v)
+{
+    __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8((char)(0x80 - 'A')));
+    __m256i is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-128 + 26)), shifted);
+    return _mm256_or_si256(v, _mm256_and_si256(is_upper, _mm256_set1_epi8(0x20)));
+}
+
+NO_SANITIZE_ADDRESS RCTARGET_AVX2 u64 string_length_avx2(const char *str)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    u32 offset = (u32)((u64)str & 31);
+    const char *block = str - offset;
+
+    u32 mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)block), zero)) >> offset;
+    if (mask)
+    {
+        return count_trailing_zeros_u32(mask);
+    }
+
+    for (;;)
+    {
+        block += 32;
+        mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)block), zero));
+        if (mask)
+        {
+            return (u64)(block - str) + count_trailing_zeros_u32(mask);
+        }
+    }
+}
+
+NO_SANITIZE_ADDRESS RCTARGET_AVX2 i64 string_find_char_avx2(const char *str, char c)
+{
+    if (c == 0)
+    {
+        return (i64)string_length_avx2(str);
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i needle = _mm256_set1_epi8(c);
+    u32 offset = (u32)((u64)str & 31);
+    const char *block = str - offset;
+
+    __m256i v = _mm256_load_si256((const __m256i *)block);
+    u32 mask = (u32)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, needle), _mm256_cmpeq_epi8(v, zero))) >> offset;
+    block += offset;
+
+    for (;;)
+    {
+        if (mask)
+        {
+            const char *hit = block + count_trailing_zeros_u32(mask);
+            return *hit == c ? (i64)(hit - str) : -1;
+        }
+
+        block = (const char *)(((u64)block & ~(u64)31) + 32);
+        v = _mm256_load_si256((const __m256i *)block);
+        mask = (u32)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, needle), _mm256_cmpeq_epi8(v, zero)));
+    }
+}
+
+NO_SANITIZE_ADDRESS RCTARGET_AVX2 b8 strings_equal_avx2(const char *str0, const char *str1)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    for (;;)
+    {
+        if (!crosses_page(str0, 32) && !crosses_page(str1, 32))
+        {
+            __m256i a = _mm256_loadu_si256((const __m256i *)str0);
+            __m256i b = _mm256_loadu_si256((const __m256i *)str1);
+            u32 diff = ~(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+            u32 end = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, zero));
+            u32 stop = diff | end;
+            if (stop)
+            {
+                u32 index = count_trailing_zeros_u32(stop);
+                return str0[index] == str1[index];
+            }
+            str0 += 32;
+            str1 += 32;
+        }
+        else
+        {
+            for (u32 i = 0; i < 32; ++i, ++str0, ++str1)
+            {
+                if (*str0 != *str1)
+                {
+                    return false;
+                }
+                if (*str0 == 0)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+}
+
+NO_SANITIZE_ADDRESS RCTARGET_AVX2 b8 strings_equali_avx2(const char *str0, const char *str1)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    for (;;)
+    {
+        if (!crosses_page(str0, 32) && !crosses_page(str1, 32))
+        {
+            __m256i a = _mm256_loadu_si256((const __m256i *)str0);
+            __m256i b = _mm256_loadu_si256((const __m256i *)str1);
+            u32 diff = ~(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(avx2_to_lower(a), avx2_to_lower(b)));
+            u32 end = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, zero));
+            u32 stop = diff | end;
+            if (stop)
+            {
+                u32 index = count_trailing_zeros_u32(stop);
+                return ascii_to_lower(str0[index]) == ascii_to_lower(str1[index]);
+            }
+            str0 += 32;
+            str1 += 32;
+        }
+        else
+        {
+            for (u32 i = 0; i < 32; ++i, ++str0, ++str1)
+            {
+                if (ascii_to_lower(*str0) != ascii_to_lower(*str1))
+                {
+                    return false;
+                }
+                if (*str0 == 0)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+}
+
+RCTARGET_AVX2 i64 string_find_avx2(const char *str, u64 str_length, const char *substring, u64 substring_length)
+{
+    const __m256i first = _mm256_set1_epi8(substring[0]);
+    const __m256i last = _mm256_set1_epi8(substring[substring_length - 1]);
+
+    u64 i = 0;
+    for (; i + 32 + substring_length - 1 <= str_length; i += 32)
+    {
+        __m256i block_first = _mm256_loadu_si256((const __m256i *)(str + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i *)(str + i + substring_length - 1));
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+        while (mask)
+        {
+            u32 bit = count_trailing_zeros_u32(mask);
+            if (memcmp(str + i + bit + 1, substring + 1, substring_length - 2) == 0)
+            {
+                return (i64)(i + bit);
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    // Finish the tail with the SSE2 kernel, which has its own scalar tail.
+    i64 result = string_find_sse2(str + i, str_length - i, substring, substring_length);
+    return result < 0 ? -1 : (i64)i + result;
+}
+
+#endif // RCARCH_X64
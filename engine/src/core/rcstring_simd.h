@@ -0,0 +1,25 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * SSE2/AVX2 kernels behind the rcstring dispatch table. Not for direct use;
+ * call the rcstring.h functions, which pick the best variant for this CPU.
+ * The find kernels take explicit lengths so they never read past the string,
+ * and require substring_length >= 2.
+ */
+#if RCARCH_X64
+
+u64 string_length_sse2(const char *str);
+b8 strings_equal_sse2(const char *str0, const char *str1);
+b8 strings_equali_sse2(const char *str0, const char *str1);
+i64 string_find_char_sse2(const char *str, char c);
+i64 string_find_sse2(const char *str, u64 str_length, const char *substring, u64 substring_length);
+
+u64 string_length_avx2(const char *str);
+b8 strings_equal_avx2(const char *str0, const char *str1);
+b8 strings_equali_avx2(const char *str0, const char *str1);
+i64 string_find_char_avx2(const char *str, char c);
+i64 string_find_avx2(const char *str, u64 str_length, const char *substring, u64 substring_length);
+
+#endif
@@ -0,0 +1,102 @@
+#include "core/string_builder.h"
+#include "core/rcstring.h"
+#include "core/rcmemory.h"
+#include "memory/linear_allocator.h"
+
+void string_builder_create(u64 capacity, char *memory, string_builder *out_builder)
+{
+    if (out_builder)
+    {
+        out_builder->buffer = memory;
+        out_builder->capacity = memory ? capacity : 0;
+        out_builder->length = 0;
+        out_builder->truncated = false;
+
+        if (out_builder->capacity > 0)
+        {
+            out_builder->buffer[0] = 0;
+        }
+    }
+}
+
+b8 string_builder_create_from_allocator(linear_allocator *allocator, u64 capacity, string_builder *out_builder)
+{
+    char *memory = linear_allocator_allocate(allocator, capacity);
+    string_builder_create(capacity, memory, out_builder);
+    return memory != 0;
+}
+
+void string_builder_clear(string_builder *builder)
+{
+    builder->length = 0;
+    builder->truncated = false;
+    if (builder->capacity > 0)
+    {
+        builder->buffer[0] = 0;
+    }
+}
+
+void string_builder_append(string_builder *builder, const char *str)
+{
+    string_builder_append_length(builder, str, string_length(str));
+}
+
+void string_builder_append_length(string_builder *builder, const char *str, u64 length)
+{
+    if (builder->capacity == 0)
+    {
+        builder->truncated = builder->truncated || length > 0;
+        return;
+    }
+
+    u64 space = builder->capacity - 1 - builder->length;
+    if (length > space)
+    {
+        length = space;
+        builder->truncated = true;
+    }
+
+    rccopy_memory(builder->buffer + builder->length, str, length);
+    builder->length += length;
+    builder->buffer[builder->length] = 0;
+}
+
+void string_builder_append_char(string_builder *builder, char c)
+{
+    if (builder->length + 1 < builder->capacity)
+    {
+        builder->buffer[builder->length++] = c;
+        builder->buffer[builder->length] = 0;
+    }
+    else
+    {
+        builder->truncated = true;
+    }
+}
+
+void string_builder_appendf(string_builder *builder, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    string_builder_appendf_v(builder, format, args);
+    va_end(args);
+}
+
+void string_builder_appendf_v(string_builder *builder, const char *format, va_list args)
+{
+    if (builder->capacity == 0)
+    {
+        builder->truncated = true;
+        return;
+    }
+
+    u64 space = builder->capacity - builder->length;
+    u64 written = string_format_v(builder->buffer + builder->length, space, format, args);
+    if (written >= space)
+    {
+        written = space - 1;
+        builder->truncated = true;
+    }
+
+    builder->length += written;
+}
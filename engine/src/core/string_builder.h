@@ -0,0 +1,54 @@
+#pragma once
+
+#include "defines.h"
+
+#include <stdarg.h>
+
+struct linear_allocator;
+
+/**
+ * Builds a null-terminated string inside caller-provided memory (a stack
+ * buffer or a linear allocator block). Never allocates. Appends past the
+ * capacity are truncated and flagged rather than overflowing.
+ */
+typedef struct string_builder
+{
+    char *buffer;
+    u64 capacity;
+    u64 length;
+    b8 truncated;
+} string_builder;
+
+/**
+ * Creates a string builder over the provided memory.
+ * @param capacity The size of memory in bytes, including room for the null terminator.
+ * @param memory The memory to write into. Must not be 0.
+ * @param out_builder A pointer to hold the created builder.
+ */
+RCAPI void string_builder_create(u64 capacity, char *memory, string_builder *out_builder);
+
+/**
+ * Creates a string builder over a block taken from the provided linear allocator.
+ * @param allocator The allocator to take the block from.
+ * @param capacity The size of the block in bytes, including room for the null terminator.
+ * @param out_builder A pointer to hold the created builder.
+ * @returns true if the block was allocated; otherwise false.
+ */
+RCAPI b8 string_builder_create_from_allocator(struct linear_allocator *allocator, u64 capacity, string_builder *out_builder);
+
+/**
+ * Resets the builder to an empty string. Does not touch the rest of the memory.
+ */
+RCAPI void string_builder_clear(string_builder *builder);
+
+RCAPI void string_builder_append(string_builder *builder, const char *str);
+RCAPI void string_builder_append_length(string_builder *builder, const char *str, u64 length);
+RCAPI void string_builder_append_char(string_builder *builder, char c);
+
+/**
+ * Appends formatted text using string_format.
+ * @param builder The builder to append to.
+ * @param format The format string.
+ */
+RCAPI void string_builder_appendf(string_builder *builder, const char *format, ...);
+RCAPI void string_builder_appendf_v(string_builder *builder, const char *format, va_list args);
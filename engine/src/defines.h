@@ -71,6 +71,13 @@ STATIC_ASSERT(sizeof(b8) == 1, "Expected b8 to be 1 byte");
 #error "Unknown platform!"
 #endif
 
+// Architecture detection
+#if defined(__x86_64__) || defined(_M_X64)
+#define RCARCH_X64 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RCARCH_ARM64 1
+#endif
+
 #ifdef RCEXPORT
 /* Exports */
 #ifdef _MSC_VER
@@ -90,6 +97,13 @@ STATIC_ASSERT(sizeof(b8) == 1, "Expected b8 to be 1 byte");
 #define RCCLAMP(value, min, max) (value <= min) ? min : (value >= max) ? max \
                                                                        : value;
 
+/* Thread-local storage */
+#ifdef _MSC_VER
+#define RCTHREAD_LOCAL __declspec(thread)
+#else
+#define RCTHREAD_LOCAL _Thread_local
+#endif
+
 /* Function inlining */
 #ifdef _MSC_VER
 #define RCINLINE __forceinline
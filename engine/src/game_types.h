@@ -16,8 +16,9 @@ typedef struct game
     // Function pointer to the game's update function.
     b8 (*update)(struct game *game_inst, f32 delta_time);
 
-    // Function pointer to the game's render function.
-    b8 (*render)(struct game *game_inst, f32 delta_time);
+    // Function pointer to the game's render function. alpha is how far between the
+    // last two fixed update steps to interpolate, or 1 without a fixed update rate.
+    b8 (*render)(struct game *game_inst, f32 delta_time, f32 alpha);
 
     // Function pointer to the game's function that'll handle resize.
     void (*on_resize)(struct game *game_inst, u32 width, u32 height);
@@ -4,6 +4,10 @@
 #include "math_types.h"
 #include "core/rcmemory.h"
 
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
 #define RC_PI 3.14159265358979323846f
 #define RC_PI_2 (2 * RC_PI)
 #define RC_HALF_PI (0.5f * RC_PI)
@@ -40,6 +44,34 @@ RCINLINE b8 is_power_of_2(u64 value)
     return (value != 0) && ((value & (value - 1)) == 0);
 }
 
+/**
+ * Returns the index of the lowest set bit. value must not be 0.
+ */
+RCINLINE u32 count_trailing_zeros_u32(u32 value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return (u32)index;
+#else
+    return (u32)__builtin_ctz(value);
+#endif
+}
+
+/**
+ * Returns the index of the lowest set bit. value must not be 0.
+ */
+RCINLINE u32 count_trailing_zeros_u64(u64 value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (u32)index;
+#else
+    return (u32)__builtin_ctzll(value);
+#endif
+}
+
 RCAPI i32 rcrandom();
 RCAPI i32 rcrandom_in_range(i32 min, i32 max);
 RCAPI f32 rcfrandom();
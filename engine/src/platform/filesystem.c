@@ -0,0 +1,120 @@
+#include "platform/filesystem.h"
+
+#include "core/logger.h"
+
+#include <stdio.h>
+#include <sys/stat.h>
+
+b8 filesystem_exists(const char *path)
+{
+    struct stat buffer;
+    return stat(path, &buffer) == 0;
+}
+
+b8 filesystem_open(const char *path, file_modes mode, b8 binary, file_handle *out_handle)
+{
+    out_handle->is_valid = false;
+    out_handle->handle = 0;
+    const char *mode_str;
+
+    if ((mode & FILE_MODE_READ) != 0 && (mode & FILE_MODE_WRITE) != 0)
+    {
+        mode_str = binary ? "w+b" : "w+";
+    }
+    else if ((mode & FILE_MODE_READ) != 0 && (mode & FILE_MODE_WRITE) == 0)
+    {
+        mode_str = binary ? "rb" : "r";
+    }
+    else if ((mode & FILE_MODE_READ) == 0 && (mode & FILE_MODE_WRITE) != 0)
+    {
+        mode_str = binary ? "wb" : "w";
+    }
+    else
+    {
+        RCERROR("Invalid mode passed while trying to open file: '%s'", path);
+        return false;
+    }
+
+    FILE *file = fopen(path, mode_str);
+    if (!file)
+    {
+        RCERROR("Error opening file: '%s'", path);
+        return false;
+    }
+
+    out_handle->handle = file;
+    out_handle->is_valid = true;
+
+    return true;
+}
+
+void filesystem_close(file_handle *handle)
+{
+    if (handle->handle)
+    {
+        fclose((FILE *)handle->handle);
+        handle->handle = 0;
+        handle->is_valid = false;
+    }
+}
+
+b8 filesystem_size(file_handle *handle, u64 *out_size)
+{
+    if (!handle->handle)
+    {
+        return false;
+    }
+
+    FILE *file = (FILE *)handle->handle;
+    long position = ftell(file);
+    if (position < 0 || fseek(file, 0, SEEK_END) != 0)
+    {
+        return false;
+    }
+    long size = ftell(file);
+    fseek(file, position, SEEK_SET);
+    if (size < 0)
+    {
+        return false;
+    }
+
+    *out_size = (u64)size;
+    return true;
+}
+
+b8 filesystem_read(file_handle *handle, u64 data_size, void *out_data, u64 *out_bytes_read)
+{
+    if (handle->handle && out_data)
+    {
+        *out_bytes_read = fread(out_data, 1, data_size, (FILE *)handle->handle);
+        if (*out_bytes_read != data_size)
+        {
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+b8 filesystem_write(file_handle *handle, u64 data_size, const void *data, u64 *out_bytes_written)
+{
+    if (handle->handle)
+    {
+        *out_bytes_written = fwrite(data, 1, data_size, (FILE *)handle->handle);
+        if (*out_bytes_written != data_size)
+        {
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+b8 filesystem_flush(file_handle *handle)
+{
+    if (handle->handle)
+    {
+        return fflush((FILE *)handle->handle) == 0;
+    }
+    return false;
+}
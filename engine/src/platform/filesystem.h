@@ -0,0 +1,75 @@
+#pragma once
+
+#include "defines.h"
+
+// Holds a handle to a file.
+typedef struct file_handle
+{
+    // Opaque handle to internal file handle.
+    void *handle;
+    b8 is_valid;
+} file_handle;
+
+typedef enum file_modes
+{
+    FILE_MODE_READ = 0x1,
+    FILE_MODE_WRITE = 0x2
+} file_modes;
+
+/**
+ * Checks if a file with the given path exists.
+ * @param path The path of the file to be checked.
+ * @returns true if exists; otherwise false.
+ */
+RCAPI b8 filesystem_exists(const char *path);
+
+/**
+ * Attempt to open file located at path.
+ * @param path The path of the file to be opened.
+ * @param mode Mode flags for the file when opened (read/write). See file_modes enum in filesystem.h.
+ * @param binary Indicates if the file should be opened in binary mode.
+ * @param out_handle A pointer to a file_handle structure which holds the handle information.
+ * @returns true if opened successfully; otherwise false.
+ */
+RCAPI b8 filesystem_open(const char *path, file_modes mode, b8 binary, file_handle *out_handle);
+
+/**
+ * Closes the provided handle to a file.
+ * @param handle A pointer to a file_handle structure which holds the handle to be closed.
+ */
+RCAPI void filesystem_close(file_handle *handle);
+
+/**
+ * Gets the size of an open file in bytes.
+ * @param handle A pointer to a file_handle structure.
+ * @param out_size A pointer to hold the size.
+ * @returns true if successful; otherwise false.
+ */
+RCAPI b8 filesystem_size(file_handle *handle, u64 *out_size);
+
+/**
+ * Reads up to data_size bytes of data into out_data.
+ * @param handle A pointer to a file_handle structure.
+ * @param data_size The number of bytes to read.
+ * @param out_data A pointer to a block of memory to be populated by this method.
+ * @param out_bytes_read A pointer to a number which will be populated with the number of bytes actually read from the file.
+ * @returns true if successful; otherwise false.
+ */
+RCAPI b8 filesystem_read(file_handle *handle, u64 data_size, void *out_data, u64 *out_bytes_read);
+
+/**
+ * Writes provided data to the file.
+ * @param handle A pointer to a file_handle structure.
+ * @param data_size The size of the data in bytes.
+ * @param data The data to be written.
+ * @param out_bytes_written A pointer to a number which will be populated with the number of bytes actually written to the file.
+ * @returns true if successful; otherwise false.
+ */
+RCAPI b8 filesystem_write(file_handle *handle, u64 data_size, const void *data, u64 *out_bytes_written);
+
+/**
+ * Pushes anything buffered for the file out to the operating system.
+ * @param handle A pointer to a file_handle structure.
+ * @returns true if successful; otherwise false.
+ */
+RCAPI b8 filesystem_flush(file_handle *handle);
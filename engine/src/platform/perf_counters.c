@@ -0,0 +1,175 @@
+#include "platform/perf_counters.h"
+
+#if RCPLATFORM_LINUX
+
+#include "core/logger.h"
+#include "core/rcmemory.h"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdatomic.h>
+
+#define PERF_COUNTER_NOT_OPEN 0xFFFFFFFFu
+
+typedef struct thread_counters
+{
+    // The group leader, which every read goes through.
+    i32 leader;
+    i32 fds[PERF_COUNTER_COUNT];
+    // Position of each counter in a group read, or PERF_COUNTER_NOT_OPEN.
+    u32 slots[PERF_COUNTER_COUNT];
+    u32 open_count;
+    b8 tried;
+    b8 open;
+} thread_counters;
+
+static RCTHREAD_LOCAL thread_counters counters;
+static _Atomic b8 warned = false;
+
+static const u64 counter_configs[PERF_COUNTER_COUNT] = {
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES};
+
+b8 perf_counters_thread_open()
+{
+    if (counters.open)
+    {
+        return true;
+    }
+    if (counters.tried)
+    {
+        return false;
+    }
+    counters.tried = true;
+
+    counters.leader = -1;
+    counters.open_count = 0;
+    i32 first_error = 0;
+    for (u32 i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+        struct perf_event_attr attr;
+        rczero_memory(&attr, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = counter_configs[i];
+        // The group starts disabled and is enabled as a whole once every member is in.
+        attr.disabled = counters.leader == -1;
+        // User space only, which is all perf_event_paranoid 2 allows.
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        i32 fd = (i32)syscall(SYS_perf_event_open, &attr, 0, -1, counters.leader, PERF_FLAG_FD_CLOEXEC);
+        if (fd < 0)
+        {
+            // Leave out what this machine cannot count, and keep the rest.
+            first_error = first_error ? first_error : errno;
+            counters.fds[i] = -1;
+            counters.slots[i] = PERF_COUNTER_NOT_OPEN;
+            continue;
+        }
+
+        if (counters.leader == -1)
+        {
+            counters.leader = fd;
+        }
+        counters.fds[i] = fd;
+        counters.slots[i] = counters.open_count++;
+    }
+
+    if (counters.leader == -1)
+    {
+        if (!atomic_exchange(&warned, true))
+        {
+            RCLOG(PLATFORM, LOG_LEVEL_WARN, "Hardware counters are unavailable: perf_event_open failed with errno %i. Check /proc/sys/kernel/perf_event_paranoid.", first_error);
+        }
+        return false;
+    }
+
+    ioctl(counters.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(counters.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    counters.open = true;
+    return true;
+}
+
+void perf_counters_thread_close()
+{
+    for (u32 i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+        if (counters.open && counters.fds[i] >= 0)
+        {
+            close(counters.fds[i]);
+        }
+    }
+    rczero_memory(&counters, sizeof(counters));
+}
+
+b8 perf_counters_read(perf_counter_sample *out_sample)
+{
+    if (!counters.open)
+    {
+        return false;
+    }
+
+    // Group read layout: count, time enabled, time running, then one value per member.
+    u64 data[3 + PERF_COUNTER_COUNT];
+    ssize_t size = read(counters.leader, data, sizeof(data));
+    if (size < (ssize_t)(sizeof(u64) * (3 + counters.open_count)))
+    {
+        return false;
+    }
+
+    out_sample->time_enabled = data[1];
+    out_sample->time_running = data[2];
+    for (u32 i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+        out_sample->raw[i] = counters.slots[i] == PERF_COUNTER_NOT_OPEN ? 0 : data[3 + counters.slots[i]];
+    }
+    return true;
+}
+
+#else
+
+// Counters are only implemented on Linux.
+
+b8 perf_counters_thread_open()
+{
+    return false;
+}
+
+void perf_counters_thread_close()
+{
+}
+
+b8 perf_counters_read(perf_counter_sample *out_sample)
+{
+    return false;
+}
+
+#endif // RCPLATFORM_LINUX
+
+void perf_counters_delta(const perf_counter_sample *start, const perf_counter_sample *end, perf_counter_values *out_values)
+{
+    // Raw counts and both times only grow, so the differences are never negative.
+    // Scaling the difference, rather than subtracting two scaled totals, keeps it that way while multiplexed.
+    u64 enabled = end->time_enabled - start->time_enabled;
+    u64 running = end->time_running - start->time_running;
+    for (u32 i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+        u64 value = end->raw[i] >= start->raw[i] ? end->raw[i] - start->raw[i] : 0;
+        if (running == 0)
+        {
+            value = 0;
+        }
+        else if (running < enabled)
+        {
+            value = (u64)((f64)value * (f64)enabled / (f64)running);
+        }
+        out_values->values[i] = value;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * Hardware performance counters for the calling thread, read through
+ * perf_event_open on Linux. Counters need permission (perf_event_paranoid
+ * of 2 or lower, or CAP_PERFMON) and hardware or a hypervisor that exposes
+ * them; where they are missing, opening fails and callers carry on without.
+ * Other platforms have no counters.
+ */
+
+typedef enum perf_counter_type
+{
+    PERF_COUNTER_INSTRUCTIONS,
+    PERF_COUNTER_CYCLES,
+    PERF_COUNTER_CACHE_MISSES,
+    PERF_COUNTER_BRANCH_MISSES,
+    PERF_COUNTER_COUNT
+} perf_counter_type;
+
+typedef struct perf_counter_values
+{
+    u64 values[PERF_COUNTER_COUNT];
+} perf_counter_values;
+
+/**
+ * Raw counts at one point in time, with how long the counters had been
+ * enabled and how long actually counting. The two times differ when the
+ * kernel multiplexes the counters with other users of the PMU. Only the
+ * difference between two samples is meaningful; see perf_counters_delta.
+ */
+typedef struct perf_counter_sample
+{
+    u64 raw[PERF_COUNTER_COUNT];
+    u64 time_enabled;
+    u64 time_running;
+} perf_counter_sample;
+
+/**
+ * Opens the counters for the calling thread, if not already open. Counters
+ * the hardware lacks read as 0. A thread that failed once does not retry.
+ * @returns true if at least one counter is open for this thread.
+ */
+RCAPI b8 perf_counters_thread_open();
+
+/**
+ * Closes the calling thread's counters.
+ */
+RCAPI void perf_counters_thread_close();
+
+/**
+ * Reads the calling thread's raw counts since it opened them.
+ * @param out_sample Receives the counts and times.
+ * @returns false if the thread has no counters open.
+ */
+RCAPI b8 perf_counters_read(perf_counter_sample *out_sample);
+
+/**
+ * Computes the counts between two samples of the same thread, scaled up
+ * for the part of the span the kernel had the counters switched out.
+ * @param start The earlier sample.
+ * @param end The later sample.
+ * @param out_values Receives the counts. All 0 if the counters never ran in between.
+ */
+RCAPI void perf_counters_delta(const perf_counter_sample *start, const perf_counter_sample *end, perf_counter_values *out_values);
+
+/**
+ * @returns Instructions per cycle, or 0 without cycle counts.
+ */
+RCINLINE f64 perf_counters_ipc(const perf_counter_values *values)
+{
+    u64 cycles = values->values[PERF_COUNTER_CYCLES];
+    return cycles ? (f64)values->values[PERF_COUNTER_INSTRUCTIONS] / (f64)cycles : 0.0;
+}
+
+/**
+ * @returns Events of the given type per thousand instructions, or 0 without instruction counts.
+ */
+RCINLINE f64 perf_counters_per_kilo_instruction(const perf_counter_values *values, perf_counter_type type)
+{
+    u64 instructions = values->values[PERF_COUNTER_INSTRUCTIONS];
+    return instructions ? (f64)values->values[type] * 1000.0 / (f64)instructions : 0.0;
+}
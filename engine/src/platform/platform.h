@@ -7,6 +7,18 @@ typedef struct platform_state
     void *internal_state;
 } platform_state;
 
+typedef struct platform_thread
+{
+    void *internal_data;
+} platform_thread;
+
+typedef struct platform_semaphore
+{
+    void *internal_data;
+} platform_semaphore;
+
+typedef u32 (*PFN_thread_start)(void *params);
+
 b8 platform_startup(
     platform_state *plat_state,
     const char *application_name,
@@ -19,10 +31,19 @@ void platform_shutdown(platform_state *plat_state);
 
 b8 platform_pump_messages(platform_state *plat_state);
 
+/**
+ * Blocks until the platform has a message to pump or the timeout passes,
+ * without using CPU in the meantime.
+ * @param timeout_ms The longest time to wait in milliseconds.
+ * @returns true if messages are waiting; false on timeout.
+ */
+b8 platform_wait_for_events(platform_state *plat_state, u64 timeout_ms);
+
 void *platform_allocate(u64 size, b8 aligned);
 void platform_free(void *block, b8 aligned);
 void *platform_zero_memory(void *block, u64 size);
 void *platform_copy_memory(void *dest, const void *source, u64 size);
+void *platform_move_memory(void *dest, const void *source, u64 size);
 void *platform_set_memory(void *dest, i32 value, u64 size);
 
 void platform_console_write(const char *message, u8 color);
@@ -30,4 +51,62 @@ void platform_console_write_error(const char *message, u8 color);
 
 f64 platform_get_absolute_time();
 
-void platform_sleep(u64 ms);
\ No newline at end of file
+/**
+ * Reads the platform's raw monotonic tick counter (QueryPerformanceCounter on
+ * Windows). Convert with platform_get_tick_frequency.
+ */
+u64 platform_get_ticks();
+
+/**
+ * @returns The number of platform ticks per second.
+ */
+u64 platform_get_tick_frequency();
+
+/**
+ * Monotonic time in nanoseconds since an arbitrary fixed point. Never goes
+ * backwards and is unaffected by wall clock changes. Integer, so it keeps
+ * full precision over any uptime.
+ */
+RCAPI u64 platform_get_time_ns();
+
+/**
+ * Reads the cheapest high-resolution counter available: the invariant TSC on
+ * x64 CPUs that have one, otherwise the platform tick counter. Meant for
+ * timing short spans; convert with platform_get_cycle_counter_frequency.
+ */
+u64 platform_read_cycle_counter();
+
+/**
+ * @returns The frequency of platform_read_cycle_counter in counts per second.
+ * Calibrated against the platform clock during platform_startup, or on first
+ * use. Counts read before calibration are platform ticks, not TSC cycles.
+ */
+u64 platform_get_cycle_counter_frequency();
+
+void platform_sleep(u64 ms);
+
+/**
+ * Starts a new thread running start_function(params).
+ * @returns true if the thread was created; otherwise false.
+ */
+b8 platform_thread_create(PFN_thread_start start_function, void *params, platform_thread *out_thread);
+
+/**
+ * Waits for a thread to return and releases its resources.
+ */
+void platform_thread_join(platform_thread *thread);
+
+b8 platform_semaphore_create(u32 initial_count, platform_semaphore *out_semaphore);
+void platform_semaphore_destroy(platform_semaphore *semaphore);
+
+/**
+ * Increments the semaphore count, waking one waiter if there is one.
+ */
+void platform_semaphore_signal(platform_semaphore *semaphore);
+
+/**
+ * Waits until the semaphore count is above zero, then decrements it.
+ * @param timeout_ms The longest time to wait in milliseconds.
+ * @returns true if the semaphore was acquired; false on timeout.
+ */
+b8 platform_semaphore_wait(platform_semaphore *semaphore, u64 timeout_ms);
\ No newline at end of file
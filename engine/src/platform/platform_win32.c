@@ -4,6 +4,7 @@
 #if RCPLATFORM_WINDOWS
 
 #include "core/logger.h"
+#include "core/cpu.h"
 #include "core/input.h"
 #include "core/event.h"
 #include "containers/darray.h"
@@ -11,6 +12,9 @@
 #include <windows.h>
 #include <windowsx.h> // param input extraction
 #include <stdlib.h>
+#if RCARCH_X64
+#include <intrin.h>
+#endif
 
 /* Includes for Vulkan (surface creation mainly)*/
 #include <vulkan/vulkan.h>
@@ -26,8 +30,13 @@ typedef struct internal_state
     VkSurfaceKHR surface;
 } internal_state;
 
-static f64 clock_frequency;
 static LARGE_INTEGER start_time;
+static u64 tick_frequency;
+static u64 cycle_frequency;
+static b8 cycle_counter_is_tsc;
+
+// How long the cycle counter is timed against QueryPerformanceCounter to find its frequency.
+#define CYCLE_CALIBRATION_NS 10000000ull
 
 LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARAM l_param);
 
@@ -112,10 +121,11 @@ b8 platform_startup(
     ShowWindow(state->hwnd, show_window_command_flags);
 
     // Clock setup
-    LARGE_INTEGER frequency;
-    QueryPerformanceFrequency(&frequency);
-    clock_frequency = 1.0 / (f64)frequency.QuadPart;
     QueryPerformanceCounter(&start_time);
+    // Make Sleep(1) last about 1 ms rather than a 15.6 ms scheduler tick, for frame pacing.
+    timeBeginPeriod(1);
+    // Calibrate now rather than on the first profiled frame.
+    platform_get_cycle_counter_frequency();
 
     return true;
 }
@@ -129,6 +139,8 @@ void platform_shutdown(platform_state *plat_state)
         DestroyWindow(state->hwnd);
         state->hwnd = 0;
     }
+
+    timeEndPeriod(1);
 }
 
 b8 platform_pump_messages(platform_state *plat_state)
@@ -143,6 +155,13 @@ b8 platform_pump_messages(platform_state *plat_state)
     return true;
 }
 
+b8 platform_wait_for_events(platform_state *plat_state, u64 timeout_ms)
+{
+    // MWMO_INPUTAVAILABLE also wakes for messages that arrived before the call but were not yet removed.
+    DWORD result = MsgWaitForMultipleObjectsEx(0, 0, (DWORD)timeout_ms, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    return result == WAIT_OBJECT_0;
+}
+
 void *platform_allocate(u64 size, b8 aligned)
 {
     return malloc(size);
@@ -163,6 +182,11 @@ void *platform_copy_memory(void *dest, const void *source, u64 size)
     return memcpy(dest, source, size);
 }
 
+void *platform_move_memory(void *dest, const void *source, u64 size)
+{
+    return memmove(dest, source, size);
+}
+
 void *platform_set_memory(void *dest, i32 value, u64 size)
 {
     return memset(dest, value, size);
@@ -197,10 +221,78 @@ void platform_console_write_error(const char *message, u8 color)
 }
 
 f64 platform_get_absolute_time()
+{
+    // Valid before platform_startup too, for the logger and headless runs.
+    return (f64)platform_get_ticks() / (f64)platform_get_tick_frequency();
+}
+
+u64 platform_get_ticks()
 {
     LARGE_INTEGER now_time;
     QueryPerformanceCounter(&now_time);
-    return (f64)now_time.QuadPart * clock_frequency;
+    return (u64)now_time.QuadPart;
+}
+
+u64 platform_get_tick_frequency()
+{
+    if (!tick_frequency)
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        tick_frequency = (u64)frequency.QuadPart;
+    }
+    return tick_frequency;
+}
+
+u64 platform_get_time_ns()
+{
+    u64 ticks = platform_get_ticks();
+    u64 frequency = platform_get_tick_frequency();
+    // Split to avoid overflowing ticks * 1e9.
+    return (ticks / frequency) * 1000000000ull + (ticks % frequency) * 1000000000ull / frequency;
+}
+
+u64 platform_read_cycle_counter()
+{
+#if RCARCH_X64
+    if (cycle_counter_is_tsc)
+    {
+        return __rdtsc();
+    }
+#endif
+    return platform_get_ticks();
+}
+
+u64 platform_get_cycle_counter_frequency()
+{
+    if (cycle_frequency)
+    {
+        return cycle_frequency;
+    }
+
+#if RCARCH_X64
+    if (cpu_has_feature(CPU_FEATURE_INVARIANT_TSC))
+    {
+        u64 start_ns = platform_get_time_ns();
+        u64 start_cycles = __rdtsc();
+        Sleep((DWORD)(CYCLE_CALIBRATION_NS / 1000000ull));
+
+        u64 end_ns;
+        do
+        {
+            end_ns = platform_get_time_ns();
+        } while (end_ns - start_ns < CYCLE_CALIBRATION_NS);
+        u64 end_cycles = __rdtsc();
+
+        cycle_counter_is_tsc = true;
+        cycle_frequency = (end_cycles - start_cycles) * 1000000000ull / (end_ns - start_ns);
+        return cycle_frequency;
+    }
+#endif
+
+    cycle_counter_is_tsc = false;
+    cycle_frequency = platform_get_tick_frequency();
+    return cycle_frequency;
 }
 
 void platform_sleep(u64 ms)
@@ -208,6 +300,52 @@ void platform_sleep(u64 ms)
     Sleep(ms);
 }
 
+b8 platform_thread_create(PFN_thread_start start_function, void *params, platform_thread *out_thread)
+{
+    out_thread->internal_data = CreateThread(0, 0, (LPTHREAD_START_ROUTINE)start_function, params, 0, 0);
+    if (!out_thread->internal_data)
+    {
+        RCERROR("platform_thread_create - CreateThread failed.");
+        return false;
+    }
+    return true;
+}
+
+void platform_thread_join(platform_thread *thread)
+{
+    if (thread->internal_data)
+    {
+        WaitForSingleObject((HANDLE)thread->internal_data, INFINITE);
+        CloseHandle((HANDLE)thread->internal_data);
+        thread->internal_data = 0;
+    }
+}
+
+b8 platform_semaphore_create(u32 initial_count, platform_semaphore *out_semaphore)
+{
+    out_semaphore->internal_data = CreateSemaphoreA(0, initial_count, 0x7FFFFFFF, 0);
+    return out_semaphore->internal_data != 0;
+}
+
+void platform_semaphore_destroy(platform_semaphore *semaphore)
+{
+    if (semaphore->internal_data)
+    {
+        CloseHandle((HANDLE)semaphore->internal_data);
+        semaphore->internal_data = 0;
+    }
+}
+
+void platform_semaphore_signal(platform_semaphore *semaphore)
+{
+    ReleaseSemaphore((HANDLE)semaphore->internal_data, 1, 0);
+}
+
+b8 platform_semaphore_wait(platform_semaphore *semaphore, u64 timeout_ms)
+{
+    return WaitForSingleObject((HANDLE)semaphore->internal_data, (DWORD)timeout_ms) == WAIT_OBJECT_0;
+}
+
 void platform_get_required_extension_names(const char ***names_darray)
 {
     darray_push(*names_darray, &"VK_KHR_win32_surface");
@@ -257,7 +395,14 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARA
         event_context context;
         context.data.u16[0] = (u16)width;
         context.data.u16[1] = (u16)height;
-        event_fire(EVENT_CODE_RESIZED, 0, context);
+        event_post(EVENT_CODE_RESIZED, 0, context);
+    }
+    break;
+    case WM_ACTIVATE:
+    {
+        event_context context;
+        context.data.u8[0] = LOWORD(w_param) != WA_INACTIVE;
+        event_post(EVENT_CODE_FOCUS_CHANGED, 0, context);
     }
     break;
     case WM_KEYDOWN:
@@ -2,6 +2,7 @@
 #include "renderer_backend.h"
 
 #include "core/logger.h"
+#include "core/profiler.h"
 #include "core/rcmemory.h"
 
 static renderer_backend *backend = 0;
@@ -49,12 +50,14 @@ void renderer_on_resized(u16 width, u16 height)
     }
     else
     {
-        RCWARN("renderer backend does not exist to accept resize: %i %i", width, height);
+        RCLOG_LIMITED(RENDERER, LOG_LEVEL_WARN, 5, "renderer backend does not exist to accept resize: %i %i", width, height);
     }
 }
 
 b8 renderer_draw_frame(render_packet *packet)
 {
+    RC_PROFILE_SCOPE_COUNTERS("renderer_draw_frame");
+
     if (renderer_begin_frame(packet->delta_time))
     {
         b8 result = renderer_end_frame(packet->delta_time);
@@ -66,5 +69,17 @@ b8 renderer_draw_frame(render_packet *packet)
         }
     }
 
+    return true;
+}
+
+b8 renderer_take_gpu_frame_time(u64 *out_ns)
+{
+    if (!backend || !backend->gpu_frame_time_ready)
+    {
+        return false;
+    }
+
+    backend->gpu_frame_time_ready = false;
+    *out_ns = backend->gpu_frame_ns;
     return true;
 }
\ No newline at end of file
@@ -10,4 +10,12 @@ void renderer_shutdown();
 
 void renderer_on_resized(u16 width, u16 height);
 
-b8 renderer_draw_frame(render_packet *packet);
\ No newline at end of file
+b8 renderer_draw_frame(render_packet *packet);
+
+/**
+ * Gets the GPU time of a recent frame. Times are measured a frame or more
+ * after the frame is drawn, and not on every backend.
+ * @param out_ns Receives the time in nanoseconds.
+ * @returns true if a time was measured since the last call.
+ */
+b8 renderer_take_gpu_frame_time(u64 *out_ns);
\ No newline at end of file
@@ -13,6 +13,9 @@ typedef struct renderer_backend
 {
     struct platform_state *plat_state;
     u64 frame_number;
+    // GPU time of a recent frame, set by the backend along with gpu_frame_time_ready when a new one is measured.
+    u64 gpu_frame_ns;
+    b8 gpu_frame_time_ready;
 
     b8 (*initialize)(struct renderer_backend *backend, const char *application_name, struct platform_state *plat_state);
 
@@ -27,4 +30,6 @@ typedef struct renderer_backend
 typedef struct render_packet
 {
     f64 delta_time;
+    // How far between the last two fixed update steps to interpolate; 1 without a fixed update rate.
+    f32 interpolation_alpha;
 } render_packet;
\ No newline at end of file
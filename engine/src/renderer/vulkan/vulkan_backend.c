@@ -6,9 +6,11 @@
 #include "vulkan_command_buffer.h"
 #include "vulkan_framebuffer.h"
 #include "vulkan_fence.h"
+#include "vulkan_timestamps.h"
 #include "vulkan_utils.h"
 #include "vulkan_device.h"
 #include "core/logger.h"
+#include "core/profiler.h"
 #include "core/rcstring.h"
 #include "core/rcmemory.h"
 #include "containers/darray.h"
@@ -69,7 +71,7 @@ b8 vulkan_renderer_backend_initialize(renderer_backend *backend, const char *app
     u32 length = darray_length(required_extensions);
     for (u32 i = 0; i < length; ++i)
     {
-        RCDEBUG(required_extensions[i]);
+        RCDEBUG("%s", required_extensions[i]);
     }
 #endif
 
@@ -211,6 +213,9 @@ b8 vulkan_renderer_backend_initialize(renderer_backend *backend, const char *app
         context.images_in_flight[i] = 0;
     }
 
+    /* GPU frame timing. Optional. */
+    vulkan_frame_timestamps_create(&context, context.swapchain.max_frames_in_flight, &context.frame_timestamps);
+
     RCINFO("Vulkan renderer initialized successfully.");
     return true;
 }
@@ -251,6 +256,8 @@ void vulkan_renderer_backend_shutdown(renderer_backend *backend)
     darray_destroy(context.images_in_flight);
     context.images_in_flight = 0;
 
+    vulkan_frame_timestamps_destroy(&context, &context.frame_timestamps);
+
     /* Destroy command buffers */
     for (u32 i = 0; i < context.swapchain.image_count; ++i)
     {
@@ -306,11 +313,13 @@ void vulkan_renderer_backend_on_resized(renderer_backend *backend, u16 width, u1
     cached_framebuffer_height = height;
     context.framebuffer_size_generation++;
 
-    RCINFO("Vulkan renderer backend->resized: w/h/gen: %i/%i/%llu", width, height, context.framebuffer_size_generation);
+    RCLOG_LIMITED(VULKAN, LOG_LEVEL_INFO, 5, "Vulkan renderer backend->resized: w/h/gen: %i/%i/%llu", width, height, context.framebuffer_size_generation);
 }
 
 b8 vulkan_renderer_backend_begin_frame(renderer_backend *backend, f32 delta_time)
 {
+    RC_PROFILE_SCOPE("vulkan begin_frame");
+
     vulkan_device *device = &context.device;
 
     if (context.recreating_swapchain)
@@ -353,6 +362,14 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend *backend, f32 delta_time
         return false;
     }
 
+    /* This frame slot's previous submission is done, so its timestamps can be read without waiting. */
+    u64 gpu_frame_ns = 0;
+    if (vulkan_frame_timestamps_read(&context, &context.frame_timestamps, context.current_frame, &gpu_frame_ns))
+    {
+        backend->gpu_frame_ns = gpu_frame_ns;
+        backend->gpu_frame_time_ready = true;
+    }
+
     if (!vulkan_swapchain_acquire_next_image_index(
             &context,
             &context.swapchain,
@@ -367,6 +384,7 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend *backend, f32 delta_time
     vulkan_command_buffer *command_buffer = &context.graphics_command_buffers[context.image_index];
     vulkan_command_buffer_reset(command_buffer);
     vulkan_command_buffer_begin(command_buffer, false, false, false);
+    vulkan_frame_timestamps_begin(&context.frame_timestamps, command_buffer, context.current_frame);
 
     /* Dynamic state */
     VkViewport viewport;
@@ -399,10 +417,13 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend *backend, f32 delta_time
 
 b8 vulkan_renderer_backend_end_frame(renderer_backend *backend, f32 delta_time)
 {
+    RC_PROFILE_SCOPE("vulkan end_frame");
+
     vulkan_command_buffer *command_buffer = &context.graphics_command_buffers[context.image_index];
 
     vulkan_renderpass_end(command_buffer, &context.main_renderpass);
 
+    vulkan_frame_timestamps_end(&context.frame_timestamps, command_buffer, context.current_frame);
     vulkan_command_buffer_end(command_buffer);
 
     if (context.images_in_flight[context.image_index] != VK_NULL_HANDLE)
@@ -466,16 +487,16 @@ VKAPI_ATTR VkBool32 VKAPI_CALL vk_debug_callback(
     {
     default:
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-        RCERROR(callback_data->pMessage);
+        RCLOG_LIMITED(VULKAN, LOG_LEVEL_ERROR, 20, "%s", callback_data->pMessage);
         break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-        RCWARN(callback_data->pMessage);
+        RCLOG_LIMITED(VULKAN, LOG_LEVEL_WARN, 20, "%s", callback_data->pMessage);
         break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-        RCINFO(callback_data->pMessage);
+        RCLOG_LIMITED(VULKAN, LOG_LEVEL_INFO, 20, "%s", callback_data->pMessage);
         break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-        RCTRACE(callback_data->pMessage);
+        RCLOG_LIMITED(VULKAN, LOG_LEVEL_TRACE, 20, "%s", callback_data->pMessage);
         break;
     }
 
@@ -23,6 +23,7 @@ typedef struct vulkan_physical_device_queue_family_info
     u32 present_family_index;
     u32 compute_family_index;
     u32 transfer_family_index;
+    u32 graphics_timestamp_valid_bits;
 } vulkan_physical_device_queue_family_info;
 
 b8 select_physical_device(vulkan_context *context);
@@ -391,6 +392,7 @@ b8 select_physical_device(vulkan_context *context)
             context->device.properties = properties;
             context->device.features = features;
             context->device.memory = memory;
+            context->device.graphics_timestamp_valid_bits = queue_info.graphics_timestamp_valid_bits;
             break;
         }
     }
@@ -444,6 +446,7 @@ b8 physical_device_meets_requirements(
         if (queue_families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
         {
             out_queue_info->graphics_family_index = i;
+            out_queue_info->graphics_timestamp_valid_bits = queue_families[i].timestampValidBits;
             ++current_transfer_score;
         }
 
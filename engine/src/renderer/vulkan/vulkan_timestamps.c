@@ -0,0 +1,99 @@
+#include "vulkan_timestamps.h"
+
+#include "core/logger.h"
+#include "containers/darray.h"
+
+b8 vulkan_frame_timestamps_create(vulkan_context *context, u32 frame_count, vulkan_frame_timestamps *out_timestamps)
+{
+    out_timestamps->query_pool = 0;
+    out_timestamps->frame_count = 0;
+    out_timestamps->pending = 0;
+
+    u32 valid_bits = context->device.graphics_timestamp_valid_bits;
+    if (valid_bits == 0)
+    {
+        RCLOG(VULKAN, LOG_LEVEL_INFO, "The graphics queue has no timestamps; GPU frame times are unavailable.");
+        return false;
+    }
+
+    VkQueryPoolCreateInfo pool_create_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    pool_create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    pool_create_info.queryCount = frame_count * 2;
+    VK_CHECK(vkCreateQueryPool(context->device.logical_device, &pool_create_info, context->allocator, &out_timestamps->query_pool));
+
+    out_timestamps->frame_count = frame_count;
+    out_timestamps->pending = darray_reserve(b8, frame_count);
+    for (u32 i = 0; i < frame_count; ++i)
+    {
+        out_timestamps->pending[i] = false;
+    }
+    out_timestamps->valid_mask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+    out_timestamps->period_ns = context->device.properties.limits.timestampPeriod;
+    return true;
+}
+
+void vulkan_frame_timestamps_destroy(vulkan_context *context, vulkan_frame_timestamps *timestamps)
+{
+    if (timestamps->query_pool)
+    {
+        vkDestroyQueryPool(context->device.logical_device, timestamps->query_pool, context->allocator);
+        timestamps->query_pool = 0;
+    }
+    if (timestamps->pending)
+    {
+        darray_destroy(timestamps->pending);
+        timestamps->pending = 0;
+    }
+    timestamps->frame_count = 0;
+}
+
+void vulkan_frame_timestamps_begin(vulkan_frame_timestamps *timestamps, vulkan_command_buffer *command_buffer, u32 frame)
+{
+    if (!timestamps->query_pool)
+    {
+        return;
+    }
+
+    vkCmdResetQueryPool(command_buffer->handle, timestamps->query_pool, frame * 2, 2);
+    vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestamps->query_pool, frame * 2);
+}
+
+void vulkan_frame_timestamps_end(vulkan_frame_timestamps *timestamps, vulkan_command_buffer *command_buffer, u32 frame)
+{
+    if (!timestamps->query_pool)
+    {
+        return;
+    }
+
+    vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamps->query_pool, frame * 2 + 1);
+    timestamps->pending[frame] = true;
+}
+
+b8 vulkan_frame_timestamps_read(vulkan_context *context, vulkan_frame_timestamps *timestamps, u32 frame, u64 *out_ns)
+{
+    if (!timestamps->query_pool || !timestamps->pending[frame])
+    {
+        return false;
+    }
+
+    // No WAIT bit: if the results are somehow not ready, skip this frame's time rather than stall.
+    u64 ticks[2];
+    VkResult result = vkGetQueryPoolResults(
+        context->device.logical_device,
+        timestamps->query_pool,
+        frame * 2,
+        2,
+        sizeof(ticks),
+        ticks,
+        sizeof(u64),
+        VK_QUERY_RESULT_64_BIT);
+    timestamps->pending[frame] = false;
+    if (result != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    u64 elapsed = ((ticks[1] & timestamps->valid_mask) - (ticks[0] & timestamps->valid_mask)) & timestamps->valid_mask;
+    *out_ns = (u64)((f64)elapsed * timestamps->period_ns);
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "vulkan_types.inl"
+
+/**
+ * Creates a timestamp query pool with a begin/end pair for each frame in flight.
+ * @returns false, leaving timestamps empty, if the graphics queue does not support timestamps.
+ */
+b8 vulkan_frame_timestamps_create(vulkan_context *context, u32 frame_count, vulkan_frame_timestamps *out_timestamps);
+
+void vulkan_frame_timestamps_destroy(vulkan_context *context, vulkan_frame_timestamps *timestamps);
+
+/**
+ * Resets the frame's queries and writes its begin timestamp. Records outside a render pass.
+ */
+void vulkan_frame_timestamps_begin(vulkan_frame_timestamps *timestamps, vulkan_command_buffer *command_buffer, u32 frame);
+
+/**
+ * Writes the frame's end timestamp once all its commands have finished.
+ */
+void vulkan_frame_timestamps_end(vulkan_frame_timestamps *timestamps, vulkan_command_buffer *command_buffer, u32 frame);
+
+/**
+ * Reads back the GPU time of the last submission for a frame slot without
+ * waiting. Call once the slot's fence has signaled, before recording it again.
+ * @returns true if a new time was read into out_ns.
+ */
+b8 vulkan_frame_timestamps_read(vulkan_context *context, vulkan_frame_timestamps *timestamps, u32 frame, u64 *out_ns);
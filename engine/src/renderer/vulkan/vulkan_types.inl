@@ -37,6 +37,8 @@ typedef struct vulkan_device
     VkPhysicalDeviceProperties properties;
     VkPhysicalDeviceFeatures features;
     VkPhysicalDeviceMemoryProperties memory;
+    // Meaningful bits in the graphics queue's timestamps; 0 if it has none.
+    u32 graphics_timestamp_valid_bits;
 
     VkFormat depth_format;
 } vulkan_device;
@@ -116,6 +118,18 @@ typedef struct vulkan_fence
     b8 is_signaled;
 } vulkan_fence;
 
+/* A pair of GPU timestamps per frame in flight, bracketing the frame's commands. */
+typedef struct vulkan_frame_timestamps
+{
+    VkQueryPool query_pool;
+    u32 frame_count;
+    /* DArray. Whether a frame's queries were written and not yet read back. */
+    b8 *pending;
+    u64 valid_mask;
+    // Nanoseconds per timestamp tick.
+    f64 period_ns;
+} vulkan_frame_timestamps;
+
 typedef struct vulkan_context
 {
     i32 (*find_memory_index)(u32 type_filter, u32 property_flags);
@@ -146,6 +160,9 @@ typedef struct vulkan_context
     /* Holds pointers to fences that exist and are owned elsewhere. */
     vulkan_fence **images_in_flight;
 
+    /* Not created when the device has no timestamp support. */
+    vulkan_frame_timestamps frame_timestamps;
+
 #if defined(_DEBUG)
     VkDebugUtilsMessengerEXT debug_messenger;
 #endif
@@ -2,6 +2,7 @@
 
 #include <entry.h>
 #include <core/rcmemory.h>
+#include <core/input.h>
 
 // Defintion of the extern declaration in entry.h.
 b8 create_game(game *out_game)
@@ -11,6 +12,22 @@ b8 create_game(game *out_game)
     out_game->app_config.start_width = 1280;
     out_game->app_config.start_height = 720;
     out_game->app_config.name = "RCGE Testbed";
+    out_game->app_config.event_trace_record_path = 0;
+    out_game->app_config.event_trace_replay_path = 0;
+    out_game->app_config.input_record_path = 0;
+    out_game->app_config.input_playback_path = 0;
+    out_game->app_config.headless = false;
+    out_game->app_config.target_frame_rate = 0;
+    out_game->app_config.background_frame_rate = 0;
+    out_game->app_config.fixed_update_rate = 0;
+    out_game->app_config.max_fixed_steps_per_frame = 8;
+    out_game->app_config.profiler_capture_key = KEY_F12;
+    out_game->app_config.profiler_capture_path = "testbed_trace.json";
+    out_game->app_config.profiler_capture_frames = 0;
+    out_game->app_config.profiler_hardware_counters = false;
+    out_game->app_config.frame_hitch_threshold_ms = 0;
+    out_game->app_config.frame_stats_dump_path = 0;
+    out_game->app_config.frame_stats_dump_interval = 0;
 
     out_game->initialize = game_initialize;
     out_game->render = game_render;
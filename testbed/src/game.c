@@ -7,7 +7,7 @@ b8 game_initialize(game *game_inst)
     return true;
 }
 
-b8 game_render(game *game_inst, f32 delta_time)
+b8 game_render(game *game_inst, f32 delta_time, f32 alpha)
 {
     return true;
 }
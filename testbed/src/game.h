@@ -12,6 +12,6 @@ b8 game_initialize(game *game_inst);
 
 b8 game_update(game *game_inst, f32 delta_time);
 
-b8 game_render(game *game_inst, f32 delta_time);
+b8 game_render(game *game_inst, f32 delta_time, f32 alpha);
 
 void game_on_resize(game *game_inst, u32 width, u32 height);
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "rchash_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <core/rchash.h>
+
+#define TEST_DATA_SIZE 4096
+// Seed for the seeded vectors.
+#define TEST_SEED 0x9e3779b97f4a7c15ull
+
+typedef struct hash_vector
+{
+    u64 size;
+    u64 seed;
+    u64 hash64;
+    u64 hash128_low;
+    u64 hash128_high;
+} hash_vector;
+
+/**
+ * Reference hashes of the first size bytes of fill_test_data's pattern.
+ * Sizes straddle the short path limit (128), the stripe (64) and the
+ * streaming buffer (256). Any change to these values changes every stored
+ * hash, so it needs a deliberate update here.
+ */
+static const hash_vector vectors[] = {
+    {0, 0x0000000000000000ull, 0x0409638ee2bde459ull, 0x0409638ee2bde459ull, 0xeb90e3729632f2d4ull},
+    {1, 0x0000000000000000ull, 0xfddeeeea8cc2709cull, 0xfddeeeea8cc2709cull, 0xa782b4ecf310558aull},
+    {3, 0x0000000000000000ull, 0xaa4dada6d17eebb0ull, 0xaa4dada6d17eebb0ull, 0x1f0031c2c0657581ull},
+    {4, 0x0000000000000000ull, 0x8d9d4657e96cc294ull, 0x8d9d4657e96cc294ull, 0xa4b0d472a5cec925ull},
+    {8, 0x0000000000000000ull, 0x9654832f28858268ull, 0x9654832f28858268ull, 0x3f51b4339d4a0fd6ull},
+    {9, 0x0000000000000000ull, 0x708e1187f06d6aaaull, 0x708e1187f06d6aaaull, 0xb09837ef93f82413ull},
+    {16, 0x0000000000000000ull, 0x36b53f8551944db0ull, 0x36b53f8551944db0ull, 0x76131b706b76fbebull},
+    {17, 0x0000000000000000ull, 0x904849bdd1e93c7cull, 0x904849bdd1e93c7cull, 0x367daa70e14136fcull},
+    {64, 0x0000000000000000ull, 0xefd3e3780f38a91cull, 0xefd3e3780f38a91cull, 0xce66a393e3ae2917ull},
+    {127, 0x0000000000000000ull, 0xeefe7c161f11d539ull, 0xeefe7c161f11d539ull, 0x1000840564b412deull},
+    {128, 0x0000000000000000ull, 0x4329d1a474b869f6ull, 0x4329d1a474b869f6ull, 0x4dd5b18c3f8f121full},
+    {129, 0x0000000000000000ull, 0x46244f78fc863181ull, 0x46244f78fc863181ull, 0x95e5273730954e34ull},
+    {240, 0x0000000000000000ull, 0xe07c8ad5d56d672aull, 0xe07c8ad5d56d672aull, 0xdda786b008107124ull},
+    {256, 0x0000000000000000ull, 0x48d2838cc3b397cfull, 0x48d2838cc3b397cfull, 0xdb37478a3255a2b7ull},
+    {257, 0x0000000000000000ull, 0xb4c08caceaeb87caull, 0xb4c08caceaeb87caull, 0x4c184cf8ad1ff476ull},
+    {1000, 0x0000000000000000ull, 0x022976d9d665cd4eull, 0x022976d9d665cd4eull, 0xf1b4695ad1c81e68ull},
+    {4096, 0x0000000000000000ull, 0xd8d261de9d1fded5ull, 0xd8d261de9d1fded5ull, 0xea23b30a050a4ffbull},
+    {0, 0x9e3779b97f4a7c15ull, 0x9ac2c3a040ba9638ull, 0x9ac2c3a040ba9638ull, 0x858c8b109a0b273bull},
+    {1, 0x9e3779b97f4a7c15ull, 0x7aee8adcc5b15f79ull, 0x7aee8adcc5b15f79ull, 0x0d5e2cac0db2ef4bull},
+    {3, 0x9e3779b97f4a7c15ull, 0xb04dd22c1258be4cull, 0xb04dd22c1258be4cull, 0xbf7ff51c3044dbc9ull},
+    {4, 0x9e3779b97f4a7c15ull, 0x72293e10e0121d24ull, 0x72293e10e0121d24ull, 0xe53d6c18ad6dec57ull},
+    {8, 0x9e3779b97f4a7c15ull, 0x296c296f23df1c71ull, 0x296c296f23df1c71ull, 0xd2730b8dc6ff8551ull},
+    {9, 0x9e3779b97f4a7c15ull, 0x4b330bf7f8843c93ull, 0x4b330bf7f8843c93ull, 0xfe3768720f2313ecull},
+    {16, 0x9e3779b97f4a7c15ull, 0x8bf7effc88c4e6bcull, 0x8bf7effc88c4e6bcull, 0x4c577cdb939c1dfeull},
+    {17, 0x9e3779b97f4a7c15ull, 0xa15cf8e4cf3a43d9ull, 0xa15cf8e4cf3a43d9ull, 0x00df9a5f3b670c51ull},
+    {64, 0x9e3779b97f4a7c15ull, 0xd2a6d28b3881b512ull, 0xd2a6d28b3881b512ull, 0xdd15871fe5e01bf0ull},
+    {127, 0x9e3779b97f4a7c15ull, 0x719e89c2bbd9e7ecull, 0x719e89c2bbd9e7ecull, 0x030ccd786d4a4df3ull},
+    {128, 0x9e3779b97f4a7c15ull, 0xc0dc65986c9a6b5eull, 0xc0dc65986c9a6b5eull, 0x8aad29ab48238cafull},
+    {129, 0x9e3779b97f4a7c15ull, 0xd25932e362fce254ull, 0xd25932e362fce254ull, 0x86304b448473267cull},
+    {240, 0x9e3779b97f4a7c15ull, 0x343a4da9602e2d8bull, 0x343a4da9602e2d8bull, 0x954ce5a99d4554bbull},
+    {256, 0x9e3779b97f4a7c15ull, 0xed7c6ab713641ecdull, 0xed7c6ab713641ecdull, 0x7387fb0db8f39039ull},
+    {257, 0x9e3779b97f4a7c15ull, 0xe0c08a47902d6aacull, 0xe0c08a47902d6aacull, 0x2c566f5746fddd43ull},
+    {1000, 0x9e3779b97f4a7c15ull, 0x0d5bc8e94d1fec5bull, 0x0d5bc8e94d1fec5bull, 0xf92c1e3890b01469ull},
+    {4096, 0x9e3779b97f4a7c15ull, 0x6a64cdfc3219ee80ull, 0x6a64cdfc3219ee80ull, 0xa9487f03eee0bf1full},
+};
+
+// Chunk sizes for feeding the streaming state, around the stripe, short path and buffer boundaries.
+static const u64 chunk_sizes[] = {1, 3, 63, 64, 65, 127, 128, 129, 255, 256, 257};
+
+// Input sizes for the streaming tests.
+static const u64 stream_sizes[] = {0, 1, 63, 64, 65, 127, 128, 129, 191, 192, 193, 255, 256, 257, 319, 320, 321, 511, 512, 513, 1000, 4096};
+
+static u8 test_data[TEST_DATA_SIZE];
+
+static void fill_test_data()
+{
+    for (u32 i = 0; i < TEST_DATA_SIZE; ++i)
+    {
+        test_data[i] = (u8)(i * 31 + 7);
+    }
+}
+
+static b8 check_vectors()
+{
+    for (u32 i = 0; i < sizeof(vectors) / sizeof(vectors[0]); ++i)
+    {
+        const hash_vector *v = &vectors[i];
+        u64 hash = rchash64(test_data, v->size, v->seed);
+        hash128 wide = rchash128(test_data, v->size, v->seed);
+        if (hash != v->hash64 || wide.low != v->hash128_low || wide.high != v->hash128_high)
+        {
+            RCERROR("--> Hash mismatch for size %llu, seed %llu.", v->size, v->seed);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static b8 known_answers()
+{
+    fill_test_data();
+    rchash_set_kernel(RCHASH_KERNEL_AUTO);
+    expect_to_be_true(check_vectors());
+
+    // Strings hash the same as their bytes.
+    expect_should_be(rchash64("hello", 5, 0), rchash_string64("hello", 0));
+    expect_should_be(rchash128("hello", 5, TEST_SEED).high, rchash_string128("hello", TEST_SEED).high);
+    return true;
+}
+
+static b8 kernels_agree()
+{
+    fill_test_data();
+
+    static const rchash_kernel kernels[] = {RCHASH_KERNEL_SCALAR, RCHASH_KERNEL_SSE2, RCHASH_KERNEL_AVX2};
+    static const char *names[] = {"scalar", "SSE2", "AVX2"};
+    for (u32 k = 0; k < sizeof(kernels) / sizeof(kernels[0]); ++k)
+    {
+        if (!rchash_set_kernel(kernels[k]))
+        {
+            RCWARN("The %s hash kernel is not supported on this CPU, skipping it.", names[k]);
+            continue;
+        }
+
+        if (!check_vectors())
+        {
+            RCERROR("--> The %s kernel disagrees with the reference hashes.", names[k]);
+            rchash_set_kernel(RCHASH_KERNEL_AUTO);
+            return false;
+        }
+
+        // Every size over the short path, against the scalar kernel.
+        for (u64 size = RCHASH_SHORT_MAX + 1; size <= 1100; ++size)
+        {
+            u64 hash = rchash64(test_data, size, TEST_SEED);
+            rchash_set_kernel(RCHASH_KERNEL_SCALAR);
+            u64 expected = rchash64(test_data, size, TEST_SEED);
+            rchash_set_kernel(kernels[k]);
+            if (hash != expected)
+            {
+                RCERROR("--> The %s kernel disagrees with scalar for size %llu.", names[k], size);
+                rchash_set_kernel(RCHASH_KERNEL_AUTO);
+                return false;
+            }
+        }
+    }
+
+    rchash_set_kernel(RCHASH_KERNEL_AUTO);
+    return true;
+}
+
+static b8 check_streaming(u64 seed)
+{
+    rchash_state state;
+    for (u32 s = 0; s < sizeof(stream_sizes) / sizeof(stream_sizes[0]); ++s)
+    {
+        u64 size = stream_sizes[s];
+        u64 expected = rchash64(test_data, size, seed);
+        hash128 expected_wide = rchash128(test_data, size, seed);
+
+        for (u32 c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++c)
+        {
+            u64 chunk = chunk_sizes[c];
+            rchash_state_reset(&state, seed);
+            for (u64 offset = 0; offset < size; offset += chunk)
+            {
+                u64 length = size - offset < chunk ? size - offset : chunk;
+                rchash_state_update(&state, test_data + offset, length);
+
+                // A digest midway leaves the state as it was.
+                if (offset + length < size)
+                {
+                    u64 partial = rchash_state_digest64(&state);
+                    if (partial != rchash64(test_data, offset + length, seed))
+                    {
+                        RCERROR("--> Partial digest mismatch at %llu bytes of %llu, chunk %llu.", offset + length, size, chunk);
+                        return false;
+                    }
+                }
+            }
+
+            hash128 wide = rchash_state_digest128(&state);
+            if (rchash_state_digest64(&state) != expected || wide.low != expected_wide.low || wide.high != expected_wide.high)
+            {
+                RCERROR("--> Streaming digest mismatch for size %llu, chunk %llu, seed %llu.", size, chunk, seed);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static b8 streaming_matches_one_shot()
+{
+    fill_test_data();
+    expect_to_be_true(check_streaming(0));
+    expect_to_be_true(check_streaming(TEST_SEED));
+    return true;
+}
+
+void rchash_register_tests()
+{
+    test_manager_register_test(known_answers, "rchash64/rchash128 match the reference hashes, seeded and unseeded.");
+    test_manager_register_test(kernels_agree, "rchash scalar, SSE2 and AVX2 kernels give the same hashes.");
+    test_manager_register_test(streaming_matches_one_shot, "rchash streaming digests match one-shot hashes for any chunking.");
+}
@@ -0,0 +1,347 @@
+#include "rcstring_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <core/rcstring.h>
+
+#include <ctype.h>
+#include <string.h>
+
+#if RCPLATFORM_WINDOWS
+#include <windows.h>
+#elif RCPLATFORM_LINUX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Strings of every length up to this are checked, which covers several SSE2 and AVX2 blocks.
+#define TEST_MAX_STRING_LENGTH 260
+#define TEST_FALLBACK_PAGE_SIZE 4096
+
+/**
+ * One readable page followed, where the platform allows, by one that faults
+ * when touched. A string whose terminator is the page's last byte makes any
+ * kernel that reads past the terminator into the next page crash the test.
+ */
+typedef struct guarded_page
+{
+    char *data;
+    u64 size;
+    void *block;
+} guarded_page;
+
+static b8 guarded_page_create(guarded_page *out_page)
+{
+#if RCPLATFORM_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    out_page->size = info.dwPageSize;
+    out_page->block = VirtualAlloc(0, out_page->size * 2, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!out_page->block)
+    {
+        return false;
+    }
+    DWORD old_protect;
+    VirtualProtect((char *)out_page->block + out_page->size, out_page->size, PAGE_NOACCESS, &old_protect);
+#elif RCPLATFORM_LINUX
+    out_page->size = (u64)sysconf(_SC_PAGESIZE);
+    out_page->block = mmap(0, out_page->size * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (out_page->block == MAP_FAILED)
+    {
+        out_page->block = 0;
+        return false;
+    }
+    mprotect((char *)out_page->block + out_page->size, out_page->size, PROT_NONE);
+#else
+    // No guard: strings still end at a page boundary, but an over-read goes unnoticed.
+    static char fallback[TEST_FALLBACK_PAGE_SIZE * 2];
+    out_page->size = TEST_FALLBACK_PAGE_SIZE;
+    out_page->block = (void *)(((u64)fallback + TEST_FALLBACK_PAGE_SIZE - 1) & ~(u64)(TEST_FALLBACK_PAGE_SIZE - 1));
+#endif
+
+    out_page->data = out_page->block;
+    return true;
+}
+
+static void guarded_page_destroy(guarded_page *page)
+{
+#if RCPLATFORM_WINDOWS
+    VirtualFree(page->block, 0, MEM_RELEASE);
+#elif RCPLATFORM_LINUX
+    munmap(page->block, page->size * 2);
+#endif
+    page->block = 0;
+    page->data = 0;
+}
+
+static u32 random_state;
+
+// A small alphabet, so substrings recur, with mixed case and a byte above 0x7F.
+static char random_char()
+{
+    static const char alphabet[] = "abAB_\xe9";
+    random_state = random_state * 1664525u + 1013904223u;
+    return alphabet[(random_state >> 16) % (sizeof(alphabet) - 1)];
+}
+
+// Places a string of the given length so its terminator is the last byte of the page.
+static char *place_string(guarded_page *page, u64 length)
+{
+    char *str = page->data + page->size - length - 1;
+    for (u64 i = 0; i < length; ++i)
+    {
+        str[i] = random_char();
+    }
+    str[length] = 0;
+    return str;
+}
+
+// Copies source so its terminator is the last byte of the page.
+static char *place_copy(guarded_page *page, const char *source, u64 length)
+{
+    char *str = page->data + page->size - length - 1;
+    memcpy(str, source, length + 1);
+    return str;
+}
+
+static i64 reference_find_char(const char *str, char c)
+{
+    const char *hit = strchr(str, c);
+    return hit ? (i64)(hit - str) : -1;
+}
+
+static i64 reference_find(const char *str, const char *substring)
+{
+    const char *hit = strstr(str, substring);
+    return hit ? (i64)(hit - str) : -1;
+}
+
+static b8 reference_equali(const char *str0, const char *str1)
+{
+    for (;; ++str0, ++str1)
+    {
+        if (tolower((unsigned char)*str0) != tolower((unsigned char)*str1))
+        {
+            return false;
+        }
+        if (*str0 == 0)
+        {
+            return true;
+        }
+    }
+}
+
+static b8 check_find(const char *name, const char *str, const char *substring)
+{
+    i64 expected = reference_find(str, substring);
+    i64 actual = string_find(str, substring);
+    if (actual != expected)
+    {
+        RCERROR("--> %s string_find of '%s' in '%s' gave %lld, expected %lld.", name, substring, str, actual, expected);
+        return false;
+    }
+    return true;
+}
+
+static b8 check_equal(const char *name, const char *str0, const char *str1)
+{
+    b8 expected = strcmp(str0, str1) == 0;
+    b8 expectedi = reference_equali(str0, str1);
+    if (strings_equal(str0, str1) != expected || strings_equali(str0, str1) != expectedi)
+    {
+        RCERROR("--> %s strings_equal/strings_equali disagree with libc for '%s' and '%s'.", name, str0, str1);
+        return false;
+    }
+    return true;
+}
+
+static b8 check_kernel(const char *name, guarded_page *page0, guarded_page *page1)
+{
+    static const char find_chars[] = {'a', 'b', 'A', 'B', '_', '\xe9', 'z', 0};
+
+    random_state = 1;
+    for (u64 length = 0; length <= TEST_MAX_STRING_LENGTH; ++length)
+    {
+        char *str = place_string(page0, length);
+
+        if (string_length(str) != length)
+        {
+            RCERROR("--> %s string_length gave %llu, expected %llu.", name, string_length(str), length);
+            return false;
+        }
+
+        for (u32 i = 0; i < sizeof(find_chars); ++i)
+        {
+            i64 expected = reference_find_char(str, find_chars[i]);
+            if (string_find_char(str, find_chars[i]) != expected)
+            {
+                RCERROR("--> %s string_find_char of %d in a string of length %llu gave %lld, expected %lld.",
+                        name, find_chars[i], length, string_find_char(str, find_chars[i]), expected);
+                return false;
+            }
+        }
+
+        // Needles taken from the start, middle and end, so they are found, plus ones that are not.
+        char needle[8];
+        for (u64 needle_length = 0; needle_length <= 5 && needle_length <= length; ++needle_length)
+        {
+            u64 starts[] = {0, (length - needle_length) / 2, length - needle_length};
+            for (u32 s = 0; s < 3; ++s)
+            {
+                memcpy(needle, str + starts[s], needle_length);
+                needle[needle_length] = 0;
+                if (!check_find(name, str, needle))
+                {
+                    return false;
+                }
+            }
+        }
+        if (!check_find(name, str, "zz") || !check_find(name, str, "ab_z") || !check_find(name, str, str))
+        {
+            return false;
+        }
+
+        // A copy, then the copy with each character changed in case and then in value.
+        char *copy = place_copy(page1, str, length);
+        if (!check_equal(name, str, copy))
+        {
+            return false;
+        }
+        for (u64 i = 0; i < length; ++i)
+        {
+            char original = copy[i];
+            copy[i] = (char)(isupper((unsigned char)original) ? tolower((unsigned char)original) : toupper((unsigned char)original));
+            b8 ok = check_equal(name, str, copy);
+            copy[i] = 'z';
+            ok = ok && check_equal(name, str, copy) && check_equal(name, copy, str);
+            copy[i] = original;
+            if (!ok)
+            {
+                return false;
+            }
+        }
+
+        // One shorter, so the strings differ only in where they end.
+        if (length > 0)
+        {
+            char *shorter = page1->data + page1->size - length;
+            memcpy(shorter, str, length - 1);
+            shorter[length - 1] = 0;
+            if (!check_equal(name, str, shorter) || !check_equal(name, shorter, str))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static b8 kernels_match_libc()
+{
+    guarded_page page0;
+    guarded_page page1;
+    if (!guarded_page_create(&page0))
+    {
+        RCERROR("--> Could not allocate a guarded page.");
+        return false;
+    }
+    if (!guarded_page_create(&page1))
+    {
+        RCERROR("--> Could not allocate a guarded page.");
+        guarded_page_destroy(&page0);
+        return false;
+    }
+
+    static const string_kernel kernels[] = {STRING_KERNEL_SCALAR, STRING_KERNEL_SSE2, STRING_KERNEL_AVX2};
+    static const char *names[] = {"scalar", "SSE2", "AVX2"};
+    b8 passed = true;
+    for (u32 k = 0; k < sizeof(kernels) / sizeof(kernels[0]) && passed; ++k)
+    {
+        if (!string_set_kernel(kernels[k]))
+        {
+            RCWARN("The %s string kernel is not supported on this CPU, skipping it.", names[k]);
+            continue;
+        }
+
+        passed = check_kernel(names[k], &page0, &page1);
+    }
+
+    string_set_kernel(STRING_KERNEL_AUTO);
+    guarded_page_destroy(&page1);
+    guarded_page_destroy(&page0);
+    return passed;
+}
+
+#define expect_format(expected, format, ...)                                                                 \
+    {                                                                                                        \
+        char buffer[64];                                                                                     \
+        u64 length = string_format(buffer, sizeof(buffer), format, __VA_ARGS__);                             \
+        if (!strings_equal(buffer, expected))                                                                \
+        {                                                                                                    \
+            RCERROR("--> Expected '%s', but got: '%s'. File: %s:%d.", expected, buffer, __FILE__, __LINE__); \
+            return false;                                                                                    \
+        }                                                                                                    \
+        expect_should_be(string_length(expected), length);                                                  \
+    }
+
+static b8 format_width_and_precision()
+{
+    expect_format("   42", "%5d", 42);
+    expect_format("42   |", "%-5d|", 42);
+    expect_format("-0042", "%05d", -42);
+    expect_format("+7", "%+d", 7);
+    expect_format(" 7", "% d", 7);
+    expect_format("    BEEF", "%8X", 0xBEEF);
+    expect_format("   7", "%*d", 4, 7);
+    expect_format("1  |", "%-*d|", 3, 1);
+    expect_format("  q", "%3c", 'q');
+
+    expect_format("005", "%.3d", 5);
+    expect_format("   005", "%6.3d", 5);
+    expect_format("3.14", "%.2f", 3.14159);
+    expect_format("    2.7183", "%10.4f", 2.718281);
+    expect_format("  -2.500", "%8.3f", -2.5);
+    expect_format("abc", "%.3s", "abcdef");
+    expect_format("xy    |", "%-6.2s|", "xyz");
+    expect_format("ab", "%.*s", 2, "abc");
+    expect_format("   ab", "%5.2s", "abc");
+    return true;
+}
+
+static b8 format_truncates()
+{
+    char buffer[16];
+
+    // Cut to capacity - 1 characters and terminated; the result is the full length and nothing past capacity is written.
+    memset(buffer, '#', sizeof(buffer));
+    expect_should_be(11, string_format(buffer, 6, "%s", "hello world"));
+    expect_to_be_true(strings_equal(buffer, "hello"));
+    expect_should_be('#', buffer[6]);
+
+    memset(buffer, '#', sizeof(buffer));
+    expect_should_be(10, string_format(buffer, 4, "%10d", 5));
+    expect_to_be_true(strings_equal(buffer, "   "));
+    expect_should_be('#', buffer[4]);
+
+    memset(buffer, '#', sizeof(buffer));
+    expect_should_be(4, string_format(buffer, 3, "%.2f", 3.14159));
+    expect_to_be_true(strings_equal(buffer, "3."));
+    expect_should_be('#', buffer[3]);
+
+    memset(buffer, '#', sizeof(buffer));
+    expect_should_be(11, string_format(buffer, 1, "%s", "hello world"));
+    expect_should_be(0, buffer[0]);
+    expect_should_be('#', buffer[1]);
+
+    // Measuring only.
+    expect_should_be(11, string_format(0, 0, "%-8s%d", "abc", 123));
+    return true;
+}
+
+void rcstring_register_tests()
+{
+    test_manager_register_test(kernels_match_libc, "rcstring scalar, SSE2 and AVX2 kernels match libc, with strings ending at a page boundary.");
+    test_manager_register_test(format_width_and_precision, "string_format applies width, flags and precision.");
+    test_manager_register_test(format_truncates, "string_format truncates to capacity and returns the full length.");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void rcstring_register_tests();
@@ -6,4 +6,11 @@
     {                                                                                                   \
         RCERROR("--> Expected %lld, but got: %lld. File: %s:%d.", expected, actual, __FILE__, __LINE__) \
         return false;                                                                                   \
-    }
\ No newline at end of file
+    }
+
+#define expect_to_be_true(actual)                                                      \
+    if (!(actual))                                                                     \
+    {                                                                                  \
+        RCERROR("--> Expected true, but got: false. File: %s:%d.", __FILE__, __LINE__) \
+        return false;                                                                  \
+    }
@@ -0,0 +1,15 @@
+#include "test_manager.h"
+
+#include "core/rchash_tests.h"
+#include "core/rcstring_tests.h"
+
+#include <core/logger.h>
+
+int main()
+{
+    rchash_register_tests();
+    rcstring_register_tests();
+
+    RCDEBUG("Starting tests...");
+    return test_manager_run_tests() ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+#include "test_manager.h"
+
+#include <core/logger.h>
+
+#define TEST_MANAGER_MAX_TESTS 256
+
+typedef struct test_entry
+{
+    PFN_test test;
+    const char *description;
+} test_entry;
+
+static test_entry tests[TEST_MANAGER_MAX_TESTS];
+static u32 test_count = 0;
+
+void test_manager_register_test(PFN_test test, const char *description)
+{
+    if (test_count == TEST_MANAGER_MAX_TESTS)
+    {
+        RCERROR("test_manager_register_test - too many tests, '%s' will not run.", description);
+        return;
+    }
+
+    tests[test_count].test = test;
+    tests[test_count].description = description;
+    test_count++;
+}
+
+u32 test_manager_run_tests()
+{
+    u32 failed = 0;
+    for (u32 i = 0; i < test_count; ++i)
+    {
+        if (tests[i].test())
+        {
+            RCINFO("[PASSED] %s", tests[i].description);
+        }
+        else
+        {
+            RCERROR("[FAILED] %s", tests[i].description);
+            failed++;
+        }
+    }
+
+    RCINFO("Results: %u passed, %u failed, %u total.", test_count - failed, failed, test_count);
+    return failed;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <defines.h>
+
+typedef b8 (*PFN_test)();
+
+/**
+ * Adds a test to the list run by test_manager_run_tests.
+ * @param test The test function. Returns true if it passed.
+ * @param description A short description printed with its result.
+ */
+void test_manager_register_test(PFN_test test, const char *description);
+
+/**
+ * Runs every registered test in order.
+ * @returns The number of tests that failed.
+ */
+u32 test_manager_run_tests();